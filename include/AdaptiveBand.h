@@ -0,0 +1,73 @@
+#include <Arduino.h>
+
+#ifndef ADAPTIVE_BAND_H
+#define ADAPTIVE_BAND_H
+
+/// @brief The hysteresis band around a setpoint, fixed until adaptation is enabled and then steered toward a target
+/// relay cycle rate.  Once per adjustment period the band widens a step while the equipment cycles more often than the target and narrows a step while it cycles
+/// less often but does cycle, an idle system leaves it alone.  It never narrows below a few times the sensor noise,
+/// estimated as the mean absolute difference between successive readings, so noise alone cannot flip the relays.
+class AdaptiveBand {
+  public:
+    /// @brief The time between band adjustments, the cycle rate is counted over the last hour so each step shows in
+    /// the count before the next one
+    static constexpr unsigned long AdjustPeriodMs = 3600000UL;  // 1 hour
+
+    /// @brief The change of one adjustment in hundredths of a degree celcius
+    static constexpr int16_t StepCentiC = 5;
+
+    /// @brief The narrowest band as a multiple of the sensor noise
+    static constexpr uint8_t NoiseMultiple = 4;
+
+    /// @brief Constructor for a fixed band
+    /// @param bandCentiC The band on either side of the setpoint in hundredths of a degree celcius, where adaptation
+    /// starts from
+    explicit AdaptiveBand(int16_t bandCentiC);
+
+    /// @brief Start adapting the band from where it is
+    /// @param minCentiC The narrowest band in hundredths of a degree celcius
+    /// @param maxCentiC The widest band in hundredths of a degree celcius
+    /// @param targetCyclesPerHour The relay cycles per hour to steer toward
+    void Enable(int16_t minCentiC, int16_t maxCentiC, uint8_t targetCyclesPerHour);
+
+    /// @brief Account a reading and adjust the band when the period has passed, call this once per HVAC decision
+    /// @param tempCentiC The temperature in hundredths of a degree celcius
+    /// @param cyclesPerHour The cycles over the last hour of the relay the current mode runs, 0 when off
+    /// @param nowMs The current time
+    void Update(int16_t tempCentiC, uint16_t cyclesPerHour, unsigned long nowMs);
+
+    /// @brief Getter for the band
+    /// @return The band on either side of the setpoint in hundredths of a degree celcius
+    int16_t BandCentiC() const;
+
+    /// @brief Getter for the sensor noise estimate
+    /// @return The mean absolute difference between successive readings in hundredths of a degree celcius
+    int16_t NoiseCentiC() const;
+
+  private:
+    /// @brief The band on either side of the setpoint
+    int16_t _bandCentiC;
+
+    /// @brief The narrowest band
+    int16_t _minCentiC = 0;
+
+    /// @brief The widest band
+    int16_t _maxCentiC = 0;
+
+    /// @brief The relay cycles per hour to steer toward, 0 while the band is fixed
+    uint8_t _targetCyclesPerHour = 0;
+
+    /// @brief The mean absolute difference between successive readings in sixteenths of a hundredth of a degree
+    uint16_t _noiseScaled = 0;
+
+    /// @brief The last reading
+    int16_t _lastTempCentiC = 0;
+
+    /// @brief Flag for if there is a last reading
+    bool _hasReading = false;
+
+    /// @brief The time of the last adjustment
+    unsigned long _lastAdjustMs = 0;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include <Arduino.h>
+#include "PinController.h"
+
+#ifndef THERMOSTATIO_BOARDPINS_H
+#define THERMOSTATIO_BOARDPINS_H
+
+/// The boards the thermostat is wired up on
+enum ThermostatBoard : uint8_t {
+  Esp32S2DevBoard = 0,
+  DefaultBoard = 1,
+};
+
+/// The pin map of a board, one specialization per board
+template<ThermostatBoard Board>
+struct BoardPins;
+
+template<>
+struct BoardPins<Esp32S2DevBoard> {
+  static constexpr uint8_t I2cScl = 18;
+  static constexpr uint8_t I2cSda = 21;
+
+  static constexpr uint8_t ButtonUp = 39;
+  static constexpr uint8_t ButtonDown = 40;
+  static constexpr uint8_t TempModeToggle = 37;
+  static constexpr uint8_t HeatModeToggle = 38;
+
+  // outputs
+  static constexpr uint8_t LedHeat = 4;
+  static constexpr uint8_t LedCool = 5;
+  static constexpr uint8_t LedFan = 6;
+};
+
+//template<>
+//struct BoardPins<SeeedBoard> {
+//  static constexpr uint8_t ButtonUp = 10;
+//  static constexpr uint8_t ButtonDown = 9;
+//  static constexpr uint8_t TempModeToggle = 8;
+//  static constexpr uint8_t HeatModeToggle = 7;
+//
+//  // outputs
+//  static constexpr uint8_t LedHeat = 0;
+//  static constexpr uint8_t LedCool = 1;
+//  static constexpr uint8_t LedFan = 2;
+//};
+
+template<>
+struct BoardPins<DefaultBoard> {
+  // the core's default I2C pins, used for bus recovery
+  static constexpr uint8_t I2cScl = SCL;
+  static constexpr uint8_t I2cSda = SDA;
+
+  static constexpr uint8_t ButtonUp = 21;
+  static constexpr uint8_t ButtonDown = 20;
+  static constexpr uint8_t TempModeToggle = 19;
+  static constexpr uint8_t HeatModeToggle = 18;
+
+  // outputs
+  static constexpr uint8_t LedHeat = 4;
+  static constexpr uint8_t LedCool = 5;
+  static constexpr uint8_t LedFan = 6;
+};
+
+#ifdef ESP32_S2_DEV
+/// The board being built for
+constexpr ThermostatBoard CurrentBoard = Esp32S2DevBoard;
+#else
+/// The board being built for
+constexpr ThermostatBoard CurrentBoard = DefaultBoard;
+#endif
+
+/// The pin map of the board being built for
+typedef BoardPins<CurrentBoard> Pins;
+
+// the pins of the thermostat, every access resolves to its register at compile time where the board allows it
+typedef PinController<Pins::ButtonUp, INPUT> UpButtonPin;
+typedef PinController<Pins::ButtonDown, INPUT> DownButtonPin;
+typedef PinController<Pins::HeatModeToggle, INPUT> HeatModeButtonPin;
+typedef PinController<Pins::TempModeToggle, INPUT> TempModeButtonPin;
+typedef PinController<Pins::LedCool, OUTPUT> CoolRelayPin;
+typedef PinController<Pins::LedHeat, OUTPUT> HeatRelayPin;
+typedef PinController<Pins::LedFan, OUTPUT> FanRelayPin;
+
+#endif //THERMOSTATIO_BOARDPINS_H
@@ -0,0 +1,45 @@
+#include <Arduino.h>
+
+#ifndef COMFORT_METRICS_H
+#define COMFORT_METRICS_H
+
+/// @brief Derived comfort values from a temperature and relative humidity sample.
+/// All math is table or polynomial driven so the FPU-less targets never call log/exp.
+class ComfortMetrics {
+  public:
+    /// @brief The lowest temperature covered by the saturation tables in celcius
+    static constexpr int8_t TableMinTempC = -20;
+
+    /// @brief The step between saturation table entries in celcius
+    static constexpr int8_t TableStepC = 2;
+
+    /// @brief The number of entries in the saturation tables
+    static constexpr uint8_t TableSize = 41;
+
+    /// @brief Dew point from the Magnus saturation curve, interpolated from a lookup table
+    /// @param tempC The dry bulb temperature in celcius
+    /// @param humidityRel The relative humidity in percent
+    /// @return The dew point in celcius, clamped to the table range
+    static float DewPointC(float tempC, float humidityRel);
+
+    /// @brief Absolute humidity interpolated from a saturated vapor density table
+    /// @param tempC The dry bulb temperature in celcius
+    /// @param humidityRel The relative humidity in percent
+    /// @return The water vapor density in grams per cubic meter
+    static float AbsoluteHumidity(float tempC, float humidityRel);
+
+    /// @brief Heat index using the Rothfusz regression in celcius, falls back to the dry bulb temperature
+    /// outside of the regression's valid range
+    /// @param tempC The dry bulb temperature in celcius
+    /// @param humidityRel The relative humidity in percent
+    /// @return The apparent temperature in celcius
+    static float HeatIndexC(float tempC, float humidityRel);
+
+  private:
+    /// @brief Linear interpolation into one of the saturation tables
+    /// @param table The PROGMEM table to read from
+    /// @param tempC The temperature to look up, clamped to the table range
+    static float _interpolate(const float *table, float tempC);
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include <Arduino.h>
+#include "ThermostatModes.h"
+#include "RelayRuntimeStats.h"
+#include "RecoveryModel.h"
+#include "I2cArbiter.h"
+
+#ifndef CONTROL_SNAPSHOT_H
+#define CONTROL_SNAPSHOT_H
+
+/// @brief Everything the display and the serial console show about the control side, copied in one piece after each
+/// control step so the UI never sees a reading from one step next to relay states from another
+struct ControlSnapshot {
+  /// @brief The temperature in tenths of a degree celcius
+  int16_t tempTenthsC;
+
+  /// @brief The dew point in tenths of a degree celcius
+  int16_t dewPointTenthsC;
+
+  /// @brief The heat index in tenths of a degree celcius
+  int16_t heatIndexTenthsC;
+
+  /// @brief The heating setpoint in tenths of a degree celcius
+  int16_t setHeatTenthsC;
+
+  /// @brief The cooling setpoint in tenths of a degree celcius
+  int16_t setCoolTenthsC;
+
+  /// @brief The number of button presses and releases seen, wraps
+  uint16_t inputEdgeCount;
+
+  /// @brief The cooling system cycles over the last hour
+  uint16_t coolCyclesPerHour;
+
+  /// @brief The heating system cycles over the last hour
+  uint16_t heatCyclesPerHour;
+
+  /// @brief The band on either side of the setpoint in hundredths of a degree celcius
+  int16_t hysteresisBandCentiC;
+
+  /// @brief The sensor noise the band is kept above in hundredths of a degree celcius
+  int16_t sensorNoiseCentiC;
+
+  /// @brief The number of console setting changes applied, wraps
+  uint16_t settingCommandCount;
+
+  /// @brief The relative humidity in percent
+  float humidityRel;
+
+  /// @brief The absolute humidity in grams per cubic meter
+  float absoluteHumidity;
+
+  /// @brief The HVAC mode
+  ThermostatHvacMode heatMode;
+
+  /// @brief The unit temperatures are shown in
+  ThermostatTemperatureMode tempMode;
+
+  /// @brief Flag for if the reading is recent enough to control on
+  bool isReadingValid;
+
+  /// @brief Flag for if the cooling relay is on
+  bool isCoolOn;
+
+  /// @brief Flag for if the heating relay is on
+  bool isHeatOn;
+
+  /// @brief Flag for if the fan relay is on
+  bool isFanOn;
+};
+
+/// @brief Single writer, many reader seqlock around a \a ControlSnapshot.  The writer never waits: it bumps the
+/// sequence to odd, copies, and bumps it back to even.  A reader copies and retries if the sequence was odd or moved
+/// while it copied, so a control task preempting the UI mid copy costs the UI a retry and never the other way around.
+class ControlSnapshotBuffer {
+  public:
+    /// @brief Publish a new snapshot, only ever call this from one task
+    /// @param snapshot The snapshot to publish
+    void Publish(const ControlSnapshot & snapshot);
+
+    /// @brief Copy out the last published snapshot
+    /// @param snapshot The snapshot to fill in
+    void Read(ControlSnapshot & snapshot) const;
+
+  private:
+    /// @brief Even while the snapshot is stable, odd while it is being written
+    volatile uint32_t _sequence = 0;
+
+    /// @brief The last published snapshot
+    ControlSnapshot _snapshot = ControlSnapshot();
+};
+
+/// @brief The relay counters and the learned recovery, too big to copy every control step so they are only copied
+/// when the console asks for them
+struct RuntimeReport {
+  /// @brief The cooling relay counters
+  RelayRuntimeStats cool;
+
+  /// @brief The heating relay counters
+  RelayRuntimeStats heat;
+
+  /// @brief The fan relay counters
+  RelayRuntimeStats fan;
+
+  /// @brief What has been learned about the heating and cooling system
+  RecoveryModel recovery;
+
+  /// @brief The time the report was copied
+  unsigned long nowMs;
+};
+
+/// @brief The control side counters behind the stats command, copied and reset by the control side when the console
+/// asks for them so no reset is lost to a step in flight
+struct StatsReport {
+  /// @brief The control steps since the last report
+  unsigned long loopCount;
+
+  /// @brief The longest control step in microseconds since the last report
+  unsigned long maxLoopMicros;
+
+  /// @brief The furthest a control step started from its fixed period in microseconds since the last report, 0
+  /// unless the control side runs in its own task
+  unsigned long maxControlJitterMicros;
+
+  /// @brief The time from boot to the first relay decision in microseconds
+  unsigned long firstDecisionMicros;
+
+  /// @brief The failed sensor reads since boot
+  unsigned long sensorErrors;
+
+  /// @brief The sensor re-initializations since boot
+  unsigned long sensorReinits;
+
+  /// @brief The times periodic acquisition fell back to single shot since boot
+  unsigned long sensorFallbacks;
+
+  /// @brief The bus recoveries since boot
+  unsigned long i2cRecoveries;
+
+  /// @brief The bus accounting of each client since the last report
+  I2cClientStats i2c[I2cClientCount];
+
+  /// @brief The time the report was copied
+  unsigned long nowMs;
+};
+
+/// @brief Request and reply hand off of a report too big to copy every control step.  The UI side requests, the
+/// control side fills the report in at its next step and marks it ready, the UI side prints it and releases it.
+/// Only the side the state names touches the report, so neither ever sees it half written.
+/// @tparam Report The report handed off
+template<typename Report>
+class ReportExchange {
+  public:
+    /// @brief Ask for a report, only ever call this from the UI side
+    /// @return False if a report is already outstanding
+    bool Request() {
+      if(_state != ReportIdle) return false;
+
+      _state = ReportRequested;
+      return true;
+    }
+
+    /// @brief Getter for the report to fill in, only ever call this from the control side
+    /// @return The report while one has been requested, nullptr otherwise
+    Report *Requested() {
+      if(_state != ReportRequested) return nullptr;
+      __sync_synchronize();
+
+      return &_report;
+    }
+
+    /// @brief Mark the requested report filled in, only ever call this from the control side
+    void Fulfil() {
+      __sync_synchronize();
+      _state = ReportFilled;
+    }
+
+    /// @brief Getter for the filled in report, only ever call this from the UI side
+    /// @return The report once it is ready, nullptr otherwise
+    const Report *Ready() const {
+      if(_state != ReportFilled) return nullptr;
+      __sync_synchronize();
+
+      return &_report;
+    }
+
+    /// @brief Hand the report back once it has been read, only ever call this from the UI side
+    void Release() {
+      __sync_synchronize();
+      _state = ReportIdle;
+    }
+
+  private:
+    /// @brief Who owns the report
+    enum State : uint8_t {
+      ReportIdle = 0,       // the UI side, nothing asked for
+      ReportRequested = 1,  // the control side, to fill in
+      ReportFilled = 2,     // the UI side, to read
+    };
+
+    /// @brief Who owns the report
+    volatile State _state = ReportIdle;
+
+    /// @brief The report
+    Report _report = Report();
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include "Adafruit_SSD1306.h"
 
 #include "StableDebouncer.h"
+#include "I2cArbiter.h"
 
 #ifndef THERMOSTATIO_DISPLAY_H
 #define THERMOSTATIO_DISPLAY_H
@@ -62,7 +63,101 @@ private:
 
   int8_t _positions[_numStars][3] = {{0}};
 
+  /// Optional callback to draw text on top of the animation before each frame is pushed
+  void (*_overlay)(Adafruit_SSD1306 &) = nullptr;
+
+  /// The arbiter for the bus the display is on, frames are pushed through it a page at a time, may be null
+  I2cArbiter *_arbiter = nullptr;
+
+  /// The I2C address of the display
+  uint8_t _address = 0;
+
+  /// Set when the display stopped answering, frames are skipped until it answers again and is re-initialized
+  bool _isDisplayLost = false;
+
+  /// The next page of the framebuffer to push, or -1 when the last frame has been fully pushed
+  int8_t _pushPage = -1;
+
+  /// How long without input before the panel is switched off and rendering stops, 0 to never blank
+  unsigned long _idleTimeoutMs = 0;
+
+  /// The time of the last input, or of when blanking was set up
+  unsigned long _lastInputMs = 0;
+
+  /// Set while the panel is switched off, nothing is drawn or pushed until a wake
+  bool _isBlanked = false;
+
+  /// Bytes of display data per Wire transmission, leaving room for the control byte in the smallest Wire buffer
+  static const uint8_t _chunkBytes = 16;
+
+  /// Check the display is still there after a frame push, and bring it back once it answers again
+  /// @return True if frames can be pushed
+  bool _checkDisplay() {
+    if(!_arbiter) return true;
+
+    I2cBus &bus = _arbiter->Bus();
+    bool isAnswering = false;
+    _arbiter->Transact(DisplayClient, [&bus, &isAnswering, this]() { isAnswering = bus.Probe(_address); });
+
+    if(!_isDisplayLost) {
+      if(isAnswering) return true;
+
+      // it stopped answering, free the bus in case it is the one holding SDA
+      _isDisplayLost = true;
+      _arbiter->Transact(DisplayClient, [&bus]() { bus.Recover(); });
+      return false;
+    }
+
+    if(!isAnswering) return false;
+
+    // it may have lost power, run the init sequence again.  begin() clears the framebuffer too, which costs nothing
+    // here: this only runs ahead of drawing a frame, and that frame is drawn whole and pushed on every page
+    _arbiter->Transact(DisplayClient, [this]() { _display->begin(SSD1306_SWITCHCAPVCC, _address, false, false); });
+    _isDisplayLost = false;
+    return true;
+  }
+
+  /// Send a single command to the display, through the arbiter when there is one
+  void _sendCommand(uint8_t command) {
+    if(_arbiter)
+      _arbiter->Transact(DisplayClient, [this, command]() { _display->ssd1306_command(command); });
+    else
+      _display->ssd1306_command(command);
+  }
+
+  /// Push one page of the framebuffer, the address window is set first so pages can go out on separate loop passes
+  void _pushNextPage() {
+    TwoWire &wire = _arbiter->Bus().Wire();
+    uint8_t *page = _display->getBuffer() + _pushPage * _display->width();
+
+    _arbiter->Transact(DisplayClient, [this, &wire, page]() {
+      _display->ssd1306_command(SSD1306_PAGEADDR);
+      _display->ssd1306_command(_pushPage);
+      _display->ssd1306_command(_pushPage);
+      _display->ssd1306_command(SSD1306_COLUMNADDR);
+      _display->ssd1306_command(0);
+      _display->ssd1306_command(_display->width() - 1);
+
+      int16_t sent;
+      for(sent = 0; sent < _display->width(); sent += _chunkBytes) {
+        wire.beginTransmission(_address);
+        wire.write((uint8_t)0x40);
+        wire.write(page + sent, _chunkBytes);
+        wire.endTransmission();
+      }
+    });
+
+    if(++_pushPage < _display->height() / 8)
+      return;
+
+    _pushPage = -1;
+    _checkDisplay();
+  }
+
   void _drawAnimationFrame() {
+    if(_isDisplayLost && !_checkDisplay())
+      return;
+
     _display->clearDisplay();
 
     int8_t i;
@@ -76,6 +171,15 @@ private:
         _resetStarPosition(i);
     }
 
+    if(_overlay)
+      _overlay(*_display);
+
+    if(_arbiter) {
+      // pushed a page per loop pass so the sensor never waits behind a whole frame
+      _pushPage = 0;
+      return;
+    }
+
     _display->display();
   }
 
@@ -98,7 +202,70 @@ public:
       _resetStarPosition(i);
   }
 
+  /**
+   * Set a function to draw status information over the animation
+   * @param overlay The function to call with the display on every frame, or nullptr for none
+   */
+  void SetOverlay(void (*overlay)(Adafruit_SSD1306 &)) {
+    _overlay = overlay;
+  }
+
+  /**
+   * Push frames through the bus arbiter a page at a time, and watch the display for bus errors, a display that stops
+   * answering is skipped and re-initialized once it is back
+   * @param arbiter The arbiter for the bus the display is on
+   * @param address The I2C address of the display
+   */
+  void SetArbiter(I2cArbiter *arbiter, uint8_t address) {
+    _arbiter = arbiter;
+    _address = address;
+  }
+
+  /**
+   * Switch the panel off and stop rendering after a stretch without input, see \a Wake
+   * @param idleTimeoutMs How long without input before blanking, 0 to never blank
+   */
+  void SetIdleTimeout(unsigned long idleTimeoutMs) {
+    _idleTimeoutMs = idleTimeoutMs;
+    _lastInputMs = millis();
+  }
+
+  /**
+   * Note input, this restarts the idle period and switches a blanked panel back on right away
+   */
+  void Wake() {
+    _lastInputMs = millis();
+
+    if(!_isBlanked) return;
+
+    _sendCommand(SSD1306_DISPLAYON);
+    _isBlanked = false;
+  }
+
+  /**
+   * Check if the panel is blanked
+   * @return True while the panel is off for inactivity
+   */
+  bool IsBlanked() const {
+    return _isBlanked;
+  }
+
   void LoopHandler() {
+    // nothing to draw and nothing on the bus until a wake
+    if(_isBlanked) return;
+
+    // finish pushing the last frame before drawing the next one
+    if(_pushPage >= 0) {
+      _pushNextPage();
+      return;
+    }
+
+    if(_idleTimeoutMs != 0 && millis() - _lastInputMs >= _idleTimeoutMs) {
+      _sendCommand(SSD1306_DISPLAYOFF);
+      _isBlanked = true;
+      return;
+    }
+
     auto wrapper = [this]() { _drawAnimationFrame(); };
     _redrawDebouncer.Execute(wrapper);
   }
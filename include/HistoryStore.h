@@ -0,0 +1,212 @@
+#include <Arduino.h>
+
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+/*
+ * Reading and relay history kept on the unit, in fixed size blocks.  Readings are downsampled to one sample per
+ * interval and stored as zigzag varint deltas from the previous sample, relay changes are stored as they happen.
+ *
+ *   block header (little endian):
+ *     uint8 'H', uint32 block sequence number, uint16 boot number, uint32 seconds since boot of the first sample,
+ *     uint16 sample interval in seconds, int16 first temperature in tenths of a degree celcius,
+ *     uint16 first humidity in tenths of a percent, uint8 relays at the first sample, uint16 bytes of records
+ *   records:
+ *     sample  varint(zigzag(temperature delta) << 1), varint(zigzag(humidity delta)), one interval after the previous
+ *     relays  varint(((seconds since the previous sample << 3) | relays) << 1 | 1)
+ *
+ * Relays are bit 0 cool, bit 1 heat, bit 2 fan.  A block always starts at a sample, a stretch without valid readings
+ * ends the block so the next sample gets an absolute time again.  A relay change while no block is open only shows
+ * up in the relays of the next block's first sample.
+ *
+ * Completed blocks go to LittleFS on the ESP32, and to a RAM ring elsewhere.  The control side only appends to the
+ * open block, writing completed blocks out and exporting happen from the UI side, a little per pass.  The export is
+ * one line per block header and per record:
+ *
+ *   b <sequence> <boot> <interval s> <seconds> <temperature> <humidity> <relays>   block and its first sample
+ *   s <seconds> <temperature> <humidity>                                          sample
+ *   r <seconds> <relays>                                                          relay change
+ *
+ * framed by "hist begin" and "hist end".  Seconds count from the boot of the block, temperature and humidity are
+ * tenths.
+ */
+
+/// @brief History of readings and relay changes in delta encoded blocks, with an incremental text export
+class HistoryStore {
+  public:
+    /// @brief The size of a block
+    static constexpr uint16_t BlockBytes = 256;
+
+#ifdef ARDUINO_ARCH_ESP32
+    /// @brief The number of completed blocks kept, in flash
+    static constexpr uint16_t MaxBlocks = 64;
+#else
+    /// @brief The number of completed blocks kept, in RAM
+    static constexpr uint16_t MaxBlocks = 16;
+#endif
+
+    /// @brief Constructor for the store
+    /// @param intervalMs The time between samples, whole seconds
+    explicit HistoryStore(unsigned long intervalMs);
+
+    /// @brief Mount the storage and continue after the newest stored block, call this from the UI side.  Nothing is
+    /// recorded before this.
+    /// @return False if the storage could not be mounted or set up, nothing is recorded then
+    bool Begin();
+
+    /// @brief Check if the storage is mounted
+    /// @return True once \a Begin has succeeded
+    bool IsBegun() const;
+
+    /// @brief Take a sample once per interval and note relay changes, call this after every control step
+    /// @param tempTenthsC The temperature in tenths of a degree celcius
+    /// @param humidityTenthsRel The relative humidity in tenths of a percent
+    /// @param isReadingValid False to leave the reading out and end the open block
+    /// @param relays The relay states, bit 0 cool, bit 1 heat, bit 2 fan
+    void Record(int16_t tempTenthsC, uint16_t humidityTenthsRel, bool isReadingValid, uint8_t relays);
+
+    /// @brief Write a completed block out and advance any export, call this from the UI side
+    void LoopHandler();
+
+    /// @brief Start exporting every stored block as text, one line per loop pass while the output has room.  The open
+    /// block is closed first so the export runs up to now.
+    /// @param output Where to write the export, this must report \a availableForWrite
+    /// @return False if an export is already running or the storage is not mounted
+    bool StartExport(Print & output);
+
+    /// @brief Check if an export is running
+    /// @return True until the export has been written
+    bool IsExporting() const;
+
+    /// @brief Getter for the number of completed blocks stored
+    /// @return The number of blocks
+    uint16_t StoredBlocks() const;
+
+    /// @brief Getter for the number of blocks or relay changes that could not be stored
+    /// @return The number of losses
+    unsigned long LostRecords() const;
+
+  private:
+    /// @brief The first byte of every block
+    static constexpr uint8_t _magic = 'H';
+
+    /// @brief The size of the block header
+    static constexpr uint8_t _headerBytes = 20;
+
+    /// @brief The widest sample record
+    static constexpr uint8_t _maxSampleBytes = 6;
+
+    /// @brief Room a relay change needs in the open block, the widest relay record, it is counted as lost when the
+    /// block has less.  The block itself is only completed at a sample, when the sample does not fit.
+    static constexpr uint8_t _reserveBytes = 5;
+
+    /// @brief The widest export line
+    static constexpr uint8_t _exportLineBytes = 64;
+
+    /// @brief The time between samples
+    unsigned long _intervalMs;
+
+    /// @brief Set once the storage is mounted, the control side records nothing before
+    volatile bool _isBegun = false;
+
+    /// @brief The number of this boot, one more than the newest stored block's
+    uint16_t _boot = 0;
+
+    /// @brief The sequence number of the next block opened, owned by the control side
+    uint32_t _nextSeq = 0;
+
+    /// @brief One more than the sequence number of the newest stored block, owned by the UI side
+    uint32_t _storedEndSeq = 0;
+
+    /// @brief The number of completed blocks stored
+    uint16_t _storedBlocks = 0;
+
+    /// @brief The number of blocks or relay changes the control side could not hand over, only written there
+    unsigned long _controlLostRecords = 0;
+
+    /// @brief The number of blocks the UI side could not write out, only written there
+    unsigned long _storeLostRecords = 0;
+
+    /// @brief The block being appended to by the control side
+    uint8_t _open[BlockBytes];
+
+    /// @brief The bytes used in the open block, 0 when no block is open
+    uint16_t _openLength = 0;
+
+    /// @brief A completed block waiting to be written out by the UI side
+    uint8_t _pending[BlockBytes];
+
+    /// @brief Set by the control side when \a _pending holds a block, cleared by the UI side once it is written out
+    volatile bool _isPendingFull = false;
+
+    /// @brief Set by the UI side to have the control side complete the open block early
+    volatile bool _isCloseRequested = false;
+
+    /// @brief The time of the last sample
+    unsigned long _lastSampleMs = 0;
+
+    /// @brief The seconds since boot of the last sample
+    uint32_t _lastSampleSeconds = 0;
+
+    /// @brief The last sampled temperature
+    int16_t _lastTempTenthsC = 0;
+
+    /// @brief The last sampled humidity
+    uint16_t _lastHumidityTenthsRel = 0;
+
+    /// @brief The last relay states
+    uint8_t _lastRelays = 0;
+
+    /// @brief Flag for if any sample has been taken
+    bool _hasSample = false;
+
+#ifndef ARDUINO_ARCH_ESP32
+    /// @brief The completed blocks, indexed by sequence number modulo \a MaxBlocks
+    uint8_t _blocks[MaxBlocks][BlockBytes];
+#endif
+
+    /// @brief Where the running export writes, null when no export is running
+    Print *_exportOutput = nullptr;
+
+    /// @brief Flag for if the export is waiting for the open block to be completed and written out
+    bool _isExportWaiting = false;
+
+    /// @brief The sequence number of the block being exported
+    uint32_t _exportSeq = 0;
+
+    /// @brief The block being exported
+    uint8_t _exportBlock[BlockBytes];
+
+    /// @brief The read position in the block being exported, 0 when the next block has to be loaded
+    uint16_t _exportOffset = 0;
+
+    /// @brief The time of the last decoded sample of the block being exported
+    uint32_t _exportSeconds = 0;
+
+    /// @brief The last decoded temperature of the block being exported
+    int16_t _exportTempTenthsC = 0;
+
+    /// @brief The last decoded humidity of the block being exported
+    uint16_t _exportHumidityTenthsRel = 0;
+
+    /// @brief Take a sample, opening a block if none is open
+    void _sample(int16_t tempTenthsC, uint16_t humidityTenthsRel, uint8_t relays, unsigned long nowMs);
+
+    /// @brief Append a varint to the open block
+    void _appendVarint(uint32_t value);
+
+    /// @brief Hand the open block to the UI side, counted as lost if the last one has not been written out yet
+    void _completeBlock();
+
+    /// @brief Write a completed block to storage
+    void _storeBlock(const uint8_t *block);
+
+    /// @brief Read a stored block
+    /// @return False if the block was never stored or has been overwritten
+    bool _loadBlock(uint32_t seq, uint8_t *block);
+
+    /// @brief Write the next export line
+    void _exportNext();
+};
+
+#endif
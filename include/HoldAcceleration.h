@@ -0,0 +1,74 @@
+#include <Arduino.h>
+
+#include "StableDebouncer.h"
+
+#ifndef THERMOSTATIO_HOLDACCELERATION_H
+#define THERMOSTATIO_HOLDACCELERATION_H
+
+/// One step of a press-and-hold acceleration curve
+struct HoldAccelerationStage {
+  /// How long the button must have been held for this stage to apply
+  DebounceDurationMs holdMs;
+
+  /// The number of milliseconds between repeats while in this stage
+  DebounceDurationMs repeatMs;
+
+  /// The number of increments applied on each repeat while in this stage
+  uint8_t stepMultiplier;
+};
+
+/**
+ * Press-and-hold acceleration for a repeating button.  The curve is a list of stages sorted by hold time, and while
+ * the button is held the debouncer's repeat frequency and the step size are moved along the curve.  Without a curve
+ * the debouncer is left alone and every step is a single increment.
+ */
+class HoldAcceleration {
+private:
+  /// The stages of the curve, sorted by ascending hold time
+  const HoldAccelerationStage *_stages = nullptr;
+
+  /// The number of stages in the curve
+  uint8_t _stageCount = 0;
+
+  /// The stage currently applied to the debouncer
+  uint8_t _stageIndex = 0;
+
+  /// Whether a hold is in progress
+  bool _isHeld = false;
+
+  /// The time at which the current hold started
+  unsigned long _holdStartMs = 0;
+
+  /// Point the debouncer at the current stage
+  void _applyStage(StableDebouncer & bouncer) const {
+    bouncer.SetExecuteFrequency(_stages[_stageIndex].repeatMs);
+  }
+
+public:
+  /**
+   * No acceleration, steps are always single increments at the debouncer's own frequency
+   */
+  HoldAcceleration();
+
+  /**
+   * Accelerate along a curve
+   * @param stages The stages sorted by ascending hold time, this must outlive the accelerator
+   * @param stageCount The number of stages
+   */
+  HoldAcceleration(const HoldAccelerationStage *stages, uint8_t stageCount);
+
+  /**
+   * Call this on every loop the button is held, before executing the debouncer
+   * @param bouncer The debouncer driving the repeats for this button
+   * @return The number of increments the next repeat should apply
+   */
+  uint8_t Update(StableDebouncer & bouncer);
+
+  /**
+   * Call this when the button is released, alongside the debouncer's reset
+   * @param bouncer The debouncer driving the repeats for this button
+   */
+  void Reset(StableDebouncer & bouncer);
+};
+
+#endif //THERMOSTATIO_HOLDACCELERATION_H
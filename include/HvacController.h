@@ -2,6 +2,9 @@
 #include "StableDebouncer.h"
 #include "SettingsController.h"
 #include "SensorController.h"
+#include "RelayRuntimeStats.h"
+#include "RecoveryModel.h"
+#include "AdaptiveBand.h"
 
 #ifndef HVAC_CONTROLLER_H
 #define HVAC_CONTROLLER_H
@@ -20,32 +23,149 @@ class HvacController {
   /// @brief Flag for if the fan is on
   bool _isFanOn = false;
 
-  int _pinCool;
-  int _pinHeat;
-  int _pinFan;
+  /// @brief The cooling system relay
+  CoolRelayPin _coolRelay;
 
-  const float _hvacOnBufferC = 0.5;
+  /// @brief The heating system relay
+  HeatRelayPin _heatRelay;
+
+  /// @brief The fan relay
+  FanRelayPin _fanRelay;
+
+  /// @brief The amount to over cool or over heat, fixed at the configured buffer unless adaptive
+  AdaptiveBand _band;
+
+  /// @brief Getter for the band on either side of the setpoint
+  /// @return The band in celcius
+  float _bufferC() const { return _band.BandCentiC() / 100.0; }
+
+  /// @brief Flag for if cooling should also run to pull the dew point down
+  bool _isDehumidifyOnCool = false;
+
+  /// @brief The highest dew point tolerated in cooling mode before cooling runs to dehumidify
+  float _dehumidifyMaxDewPointC = 0.0;
+
+  /// @brief How far below the limit the dew point has to fall before dehumidifying stops
+  float _dehumidifyMarginC = 0.0;
+
+  /// @brief Flag for if cooling is running for humidity, latched from the dew point limit down to the margin below it
+  bool _isDehumidifying = false;
+
+  /// @brief The least time the cooling system stays off before it can restart
+  unsigned long _coolMinOffMs = 0;
+
+  /// @brief The time the cooling system last turned off
+  unsigned long _coolOffSinceMs = 0;
+
+  /// @brief Flag for if the cooling system has turned off since boot, before that there is no off time to wait out
+  bool _hasCoolTurnedOff = false;
+
+  /// @brief Check if the cooling system has been off long enough to start
+  /// @return True if cooling is on, has not run since boot, or has been off at least the minimum off time
+  bool _canStartCool() const {
+    return _isCoolOn || !_hasCoolTurnedOff || millis() - _coolOffSinceMs >= _coolMinOffMs;
+  }
+
+  /// @brief The time since boot of the first decision made on a valid reading, 0 until then
+  unsigned long _firstDecisionMicros = 0;
+
+  /// @brief Runtime and cycle counters of the cooling system
+  RelayRuntimeStats _coolStats;
+
+  /// @brief Runtime and cycle counters of the heating system
+  RelayRuntimeStats _heatStats;
+
+  /// @brief Runtime and cycle counters of the fan
+  RelayRuntimeStats _fanStats;
+
+  /// @brief How the room responds to the heating and cooling system, learned from past cycles
+  RecoveryModel _recoveryModel;
+
+  /// @brief Flag for if the learned undershoot and overshoot move the start and stop points
+  bool _isPredictiveStartStop = false;
+
+  /// @brief How far ahead of the band edge the equipment starts, the learned undershoot up to half the buffer
+  /// @param direction Heating or cooling
+  /// @return The lead in celcius
+  float _startLeadC(RecoveryDirection direction) const {
+    return _isPredictiveStartStop ? _limitLeadC(_recoveryModel.UndershootCentiC(direction)) : 0.0;
+  }
+
+  /// @brief How far ahead of the band edge the equipment stops, the learned overshoot up to half the buffer
+  /// @param direction Heating or cooling
+  /// @return The lead in celcius
+  float _stopLeadC(RecoveryDirection direction) const {
+    return _isPredictiveStartStop ? _limitLeadC(_recoveryModel.OvershootCentiC(direction)) : 0.0;
+  }
+
+  /// @brief Limit a learned lead to half the buffer, so the start and stop points stay at least a buffer apart
+  /// @param leadCentiC The learned lead in hundredths of a degree celcius
+  /// @return The lead in celcius
+  float _limitLeadC(int16_t leadCentiC) const {
+    float leadC = leadCentiC / 100.0;
+    return leadC < _bufferC() / 2 ? leadC : _bufferC() / 2;
+  }
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+  /// @brief Flag for if the counters are saved
+  bool _isRuntimePersisted = false;
+
+  /// @brief The least time in milliseconds between saves of the counters
+  unsigned long _persistIntervalMs = 0;
+
+  /// @brief The time the counters were last handed over for saving
+  unsigned long _lastPersistMs = 0;
+
+  /// @brief The counters to save, copied on the control side and only read while \a _isPersistDue is set
+  RelayRuntimeTotals _persistTotals[3];
+
+  /// @brief Flag for if \a _persistTotals are waiting to be saved from the UI side
+  volatile bool _isPersistDue = false;
+
+  /// @brief Copy the counters for saving if the save interval has passed and the last copy has been saved
+  /// @param nowMs The current time
+  void _persistRuntime(unsigned long nowMs);
+#endif
 
   /// @brief private setter for the cooling system relay
   void _setCoolRelay() {
-    digitalWrite(_pinCool, _isCoolOn ? HIGH : LOW);
+    if(_isCoolOn) _coolRelay.SetPinOn();
+    else _coolRelay.SetPinOff();
   }
 
   /// @brief Private setter for the heating system relay
   void _setHeatRelay() {
-    digitalWrite(_pinHeat, _isHeatOn ? HIGH : LOW);
+    if(_isHeatOn) _heatRelay.SetPinOn();
+    else _heatRelay.SetPinOff();
   }
 
   /// @brief Private setter for the fan
   void _setFanRelay() {
-    digitalWrite(_pinFan, _isFanOn ? HIGH : LOW);
+    if(_isFanOn) _fanRelay.SetPinOn();
+    else _fanRelay.SetPinOff();
   }
 
-  /// @brief Private trigger for setting all relays at once
+  /// @brief Private trigger for setting all relays at once, the runtime counters only do work when a relay changes
   void _setRelays() {
     _setCoolRelay();
     _setHeatRelay();
     _setFanRelay();
+
+    unsigned long nowMs = millis();
+    bool isChanged = _coolStats.Update(_isCoolOn, nowMs);
+    if(isChanged && !_isCoolOn) {
+      _coolOffSinceMs = nowMs;
+      _hasCoolTurnedOff = true;
+    }
+    isChanged |= _heatStats.Update(_isHeatOn, nowMs);
+    isChanged |= _fanStats.Update(_isFanOn, nowMs);
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+    if(isChanged)
+      _persistRuntime(nowMs);
+#else
+    (void)isChanged;
+#endif
   }
 
   /// @brief Private setter to turn off all HVAC flags
@@ -61,11 +181,13 @@ class HvacController {
   void _setHvacHeatStates(SensorController & sensorController, SettingsController & settingsController) {
     _isCoolOn = false;
 
-    if(sensorController.CurrentTempC() >= (settingsController.SetHeatTempC() + _hvacOnBufferC)) {
+    // the heat keeps coming after a stop and takes a while to arrive after a start, so both happen ahead of the band
+    // edge by what the past cycles drifted past it
+    if(sensorController.CurrentTempC() >= (settingsController.SetHeatTempC() + _bufferC() - _stopLeadC(RecoveryHeat))) {
       _isHeatOn = false;
       _isFanOn = false;
     }
-    else if(sensorController.CurrentTempC() <= (settingsController.SetHeatTempC() - _hvacOnBufferC)) {
+    else if(sensorController.CurrentTempC() <= (settingsController.SetHeatTempC() - _bufferC() + _startLeadC(RecoveryHeat))) {
       _isHeatOn = true;
       _isFanOn = true;
     }
@@ -77,13 +199,26 @@ class HvacController {
   void _setHvacCoolStates(SensorController & sensorController, SettingsController & settingsController) {
     _isHeatOn = false;
 
-    if(sensorController.CurrentTempC() <= (settingsController.SetCoolTempC() - _hvacOnBufferC)) {
+    // muggy air latches dehumidifying on until the dew point is clearly down, so it does not flap around the limit
+    if(!_isDehumidifyOnCool)
+      _isDehumidifying = false;
+    else if(sensorController.CurrentDewPointC() >= _dehumidifyMaxDewPointC)
+      _isDehumidifying = true;
+    else if(sensorController.CurrentDewPointC() < _dehumidifyMaxDewPointC - _dehumidifyMarginC)
+      _isDehumidifying = false;
+
+    if(sensorController.CurrentTempC() <= (settingsController.SetCoolTempC() - _bufferC() + _stopLeadC(RecoveryCool))) {
       _isCoolOn = false;
       _isFanOn = false;
     }
-    else if(sensorController.CurrentTempC() >= (settingsController.SetCoolTempC() + _hvacOnBufferC)) {
-      _isCoolOn = true;
-      _isFanOn = true;
+    else if(sensorController.CurrentTempC() >= (settingsController.SetCoolTempC() + _bufferC() - _startLeadC(RecoveryCool))
+            || _isDehumidifying) {
+      // too warm, or muggy but inside the band and cooling down to the bottom of the band to wring water out of the
+      // air, either way the compressor rests its minimum off time first
+      if(_canStartCool()) {
+        _isCoolOn = true;
+        _isFanOn = true;
+      }
     }
   }
 
@@ -91,6 +226,29 @@ class HvacController {
   /// @param sensorController The sensor controller to read from to get current external readings
   /// @param settingsController The settings controller to get current settings from
   void _setHvacStates(SensorController & sensorController, SettingsController & settingsController) {
+    // never act on a reading we cannot trust, fail safe with everything off until the sensor recovers
+    if(!sensorController.IsReadingValid()) {
+      _setHvacOffStates();
+      _setRelays();
+      return;
+    }
+
+    if(_firstDecisionMicros == 0)
+      _firstDecisionMicros = micros();
+
+    // learn from the relay states the last decision left, before this one changes them
+    float tempC = sensorController.CurrentTempC();
+    int16_t tempCentiC = (int16_t)(tempC * 100.0f + (tempC < 0 ? -0.5f : 0.5f));
+    unsigned long nowMs = millis();
+    _recoveryModel.Update(_isHeatOn, _isCoolOn, tempCentiC, nowMs);
+
+    uint16_t cyclesPerHour = 0;
+    if(settingsController.CurrentHeatMode() == Heat)
+      cyclesPerHour = _heatStats.CyclesPerHour(nowMs);
+    else if(settingsController.CurrentHeatMode() == Cool)
+      cyclesPerHour = _coolStats.CyclesPerHour(nowMs);
+    _band.Update(tempCentiC, cyclesPerHour, nowMs);
+
     switch(settingsController.CurrentHeatMode()) {
       case Heat:
         _setHvacHeatStates(sensorController, settingsController);
@@ -110,7 +268,92 @@ class HvacController {
   public:
     /// @brief Controller for the HVAC relays
     /// @param hvacChangeBounceMs The number of milliseconds between changes to the HVAC equipment, be careful not to set this too low
-    HvacController(unsigned long hvacChangeBounceMs, int coolPin, int heatPin, int fanPin);
+    /// @param bufferC The amount to over cool or over heat in celcius, where an adaptive band starts from
+    /// @param coolRelay The cooling system relay
+    /// @param heatRelay The heating system relay
+    /// @param fanRelay The fan relay
+    HvacController(unsigned long hvacChangeBounceMs, float bufferC, CoolRelayPin coolRelay, HeatRelayPin heatRelay,
+                   FanRelayPin fanRelay);
+
+    /// @brief Set up the relay pins with every relay off, call this as early as possible
+    void Initialize();
+
+    /// @brief Allow cooling mode to run the cooling system while inside the temperature band when the air is too humid
+    /// @param maxDewPointC The dew point in celcius at or above which cooling will run
+    /// @param marginC How far below \p maxDewPointC the dew point has to fall before cooling stops running for it
+    void EnableDehumidifyOnCool(float maxDewPointC, float marginC);
+
+    /// @brief Stop running the cooling system for humidity alone
+    void DisableDehumidifyOnCool();
+
+    /// @brief Keep the cooling system off for a least time after it stops, whatever asks for it to restart
+    /// @param minOffMs The least off time in milliseconds, 0 to restart whenever asked
+    void SetCoolMinOffTime(unsigned long minOffMs);
+
+    /// @brief Adapt the band on either side of the setpoint to keep the cycle rate of the running system near a target,
+    /// see \a AdaptiveBand.  The band starts from the buffer given to the constructor.
+    /// @param minC The narrowest band in celcius
+    /// @param maxC The widest band in celcius
+    /// @param targetCyclesPerHour The cycles per hour to steer toward
+    void EnableAdaptiveBand(float minC, float maxC, uint8_t targetCyclesPerHour);
+
+    /// @brief Getter for the band on either side of the setpoint the relays switch at
+    /// @return The band in celcius
+    float HysteresisBandC() const;
+
+    /// @brief Getter for the sensor noise estimate the band is kept above
+    /// @return The mean absolute difference between successive readings in celcius
+    float SensorNoiseC() const;
+
+    /// @brief Start and stop ahead of the band edges by the undershoot and overshoot learned from past cycles, each at
+    /// most half the buffer.  The model learns either way, this only lets it act.
+    void EnablePredictiveStartStop();
+
+    /// @brief Start and stop at the band edges
+    void DisablePredictiveStartStop();
+
+    /// @brief Getter for how long after boot control started
+    /// @return The time since boot in microseconds of the first decision made on a valid reading, 0 until then
+    unsigned long FirstDecisionMicros() const;
+
+    /// @brief Getter for the cooling relay
+    /// @return True if the cooling system is on
+    bool IsCoolOn() const;
+
+    /// @brief Getter for the heating relay
+    /// @return True if the heating system is on
+    bool IsHeatOn() const;
+
+    /// @brief Getter for the fan relay
+    /// @return True if the fan is on
+    bool IsFanOn() const;
+
+    /// @brief Getter for the cooling system counters
+    /// @return The runtime and cycle counters
+    const RelayRuntimeStats & CoolStats() const;
+
+    /// @brief Getter for the heating system counters
+    /// @return The runtime and cycle counters
+    const RelayRuntimeStats & HeatStats() const;
+
+    /// @brief Getter for the fan counters
+    /// @return The runtime and cycle counters
+    const RelayRuntimeStats & FanStats() const;
+
+    /// @brief Getter for what has been learned about the heating and cooling system
+    /// @return The learned rates, undershoots and overshoots
+    const RecoveryModel & Recovery() const;
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+    /// @brief Restore the saved runtime counters and keep saving them after relay changes through
+    /// \a PersistRuntimeIfDue, at most once per interval so the EEPROM is not worn out by short cycling
+    /// @param minIntervalMs The least time in milliseconds between saves
+    void EnableRuntimePersistence(unsigned long minIntervalMs);
+
+    /// @brief Save the counters if a relay change has made a save due, call this from the UI side so the EEPROM write
+    /// (a flash sector erase on the ESP32) never stalls the control step
+    void PersistRuntimeIfDue();
+#endif
 
     /// @brief Loop handler for HVAC behaviors
     /// @param sensorController The sensor controller to read from to get current external readings
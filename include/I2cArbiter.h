@@ -0,0 +1,111 @@
+#include <Arduino.h>
+#include "I2cBus.h"
+
+#ifdef THERMOSTAT_RTOS_TASKS
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+#ifndef I2C_ARBITER_H
+#define I2C_ARBITER_H
+
+/// @brief The clients of the shared bus, lower values have priority
+enum I2cClient : uint8_t {
+  SensorClient = 0,
+  DisplayClient = 1,
+  I2cClientCount = 2,
+};
+
+/// @brief The bus accounting of one client over a window
+struct I2cClientStats {
+  /// @brief The bus time in microseconds
+  unsigned long busyMicros;
+
+  /// @brief The number of transactions
+  unsigned long transactions;
+
+  /// @brief The share of wall time the client held the bus, in tenths of a percent
+  uint16_t utilizationPerMille;
+};
+
+/// @brief Arbiter for the shared I2C bus.  Every transaction goes through here so bus time can be accounted per
+/// client.  Bulk clients (the display) split their work into small chunks with at most one chunk per loop pass, so a
+/// sensor transaction never waits behind more than one chunk.  With the control and UI split into tasks the bus is
+/// also guarded by a mutex, its priority inheritance lets the control task's sensor read jump the UI's next chunk.
+class I2cArbiter {
+  public:
+    /// @brief Constructor for the arbiter
+    /// @param bus The bus being shared
+    explicit I2cArbiter(I2cBus & bus);
+
+    /// @brief Getter for the bus being shared
+    /// @return The bus
+    I2cBus & Bus();
+
+    /// @brief Run a transaction for a client now
+    /// @tparam F The type of the function, be sure this requires no arguments
+    /// @param client The client the transaction belongs to
+    /// @param transaction The function doing the bus work
+    template<typename F>
+    void Transact(I2cClient client, F transaction) {
+#ifdef THERMOSTAT_RTOS_TASKS
+      xSemaphoreTake(_mutex, portMAX_DELAY);
+#endif
+      unsigned long startMicros = micros();
+
+      transaction();
+
+      _account(client, micros() - startMicros);
+#ifdef THERMOSTAT_RTOS_TASKS
+      xSemaphoreGive(_mutex);
+#endif
+    }
+
+    /// @brief Getter for the bus time a client used since the last reset
+    /// @param client The client
+    /// @return The time in microseconds
+    unsigned long BusyMicros(I2cClient client) const;
+
+    /// @brief Getter for the number of transactions a client ran since the last reset
+    /// @param client The client
+    /// @return The number of transactions
+    unsigned long Transactions(I2cClient client) const;
+
+    /// @brief Getter for the share of wall time a client held the bus since the last reset
+    /// @param client The client
+    /// @return The utilization in tenths of a percent
+    uint16_t UtilizationPerMille(I2cClient client) const;
+
+    /// @brief Copy out the accounting of every client and start a new window, in one piece under the bus mutex
+    /// @param stats The accounting to fill in, indexed by client
+    void TakeStats(I2cClientStats (&stats)[I2cClientCount]);
+
+  private:
+    /// @brief The bus being shared
+    I2cBus & _bus;
+
+    /// @brief The bus time of each client in the current window
+    unsigned long _busyMicros[I2cClientCount] = {0};
+
+    /// @brief The number of transactions of each client in the current window
+    unsigned long _transactions[I2cClientCount] = {0};
+
+    /// @brief The start of the current accounting window, in milliseconds so long windows do not wrap
+    unsigned long _windowStartMs = 0;
+
+#ifdef THERMOSTAT_RTOS_TASKS
+    /// @brief Storage for the bus mutex, statically allocated so it exists before the scheduler starts
+    StaticSemaphore_t _mutexBuffer;
+
+    /// @brief The bus mutex
+    SemaphoreHandle_t _mutex;
+#endif
+
+    /// @brief Add a transaction to a client's accounting
+    void _account(I2cClient client, unsigned long busyMicros) {
+      _busyMicros[client] += busyMicros;
+      _transactions[client]++;
+    }
+};
+
+#endif
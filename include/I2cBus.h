@@ -0,0 +1,59 @@
+#include <Arduino.h>
+#include "Wire.h"
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+/// @brief Owner of the shared I2C bus.  Configures a hard per-transaction timeout where the core supports one, so a
+/// device holding SDA low can no longer hang the loop, and can recover a stuck bus by clocking it free.
+class I2cBus {
+  public:
+    /// @brief Constructor for the bus
+    /// @param wire The Wire instance of the bus
+    /// @param sdaPin The data pin, used for bus recovery
+    /// @param sclPin The clock pin, used for bus recovery
+    /// @param clockHz The bus clock
+    /// @param timeoutMs The upper bound on any single transaction
+    I2cBus(TwoWire & wire, uint8_t sdaPin, uint8_t sclPin, uint32_t clockHz, uint16_t timeoutMs);
+
+    /// @brief Start the bus with the configured clock and timeout
+    void Begin();
+
+    /// @brief Check if a device acknowledges its address
+    /// @param address The 7 bit device address
+    /// @return True if the device answered
+    bool Probe(uint8_t address);
+
+    /// @brief Free a bus where a device is holding SDA low: up to nine clock pulses until SDA is released, then a
+    /// STOP condition, then restart the bus.  This takes about a tenth of a millisecond.
+    void Recover();
+
+    /// @brief Getter for the Wire instance of the bus
+    /// @return The Wire instance
+    TwoWire & Wire();
+
+    /// @brief Getter for the number of bus recoveries
+    /// @return The number of times \a Recover has run
+    unsigned long RecoveryCount() const;
+
+  private:
+    /// @brief The Wire instance of the bus
+    TwoWire & _wire;
+
+    /// @brief The data pin
+    uint8_t _sdaPin;
+
+    /// @brief The clock pin
+    uint8_t _sclPin;
+
+    /// @brief The bus clock
+    uint32_t _clockHz;
+
+    /// @brief The upper bound on any single transaction
+    uint16_t _timeoutMs;
+
+    /// @brief The number of bus recoveries
+    unsigned long _recoveryCount = 0;
+};
+
+#endif
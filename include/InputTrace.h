@@ -0,0 +1,112 @@
+#include <Arduino.h>
+
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+/*
+ * Compact binary trace of everything the control path reads from the outside world, for deterministic replay on
+ * the host (see src/replay/ReplayHarness.cpp).
+ *
+ *   header:  'T' 'I' 'O' <version> <board>
+ *   record:  <tag> <varint milliseconds since the previous record> <payload>
+ *
+ *   InputTraceSensor  payload: int16 temperature in hundredths of a degree celcius, uint16 humidity in hundredths of
+ *                     a percent, both little endian.  Written only when the reading changes.
+ *   InputTracePin     payload: uint8 pin number, uint8 level read from the pin.  Written only on edges.
+ *   InputTraceSensorError  no payload.  The sensor read failed, written once per run of failures.
+ *   InputTraceSetting  payload: uint8 SettingCommandKind, int16 value little endian.  A console setting change,
+ *                      written when the control step applies it.
+ *
+ * The board is the ThermostatBoard the trace was recorded on, pin records carry that board's pin numbers.
+ */
+
+/// @brief The trace format version written in the header
+#define INPUT_TRACE_VERSION 2
+
+/// @brief The record tags of an input trace
+enum InputTraceTag : uint8_t {
+  InputTraceSensor = 1,
+  InputTracePin = 2,
+  InputTraceSensorError = 3,
+  InputTraceSetting = 4,
+};
+
+/// @brief Writes an input trace to a Print.  Records are written whole or not at all, records that do not fit in
+/// the output are counted as lost instead of blocking the loop.
+class InputTraceRecorder {
+  public:
+    /// @brief The number of distinct pins whose edges can be tracked
+    static constexpr uint8_t MaxPins = 8;
+
+    /// @brief Constructor for the recorder
+    /// @param output Where to write the trace, this must report \a availableForWrite
+    explicit InputTraceRecorder(Print & output);
+
+    /// @brief Write the trace header with the board being built for and make this the recorder the hooks report to
+    void Begin();
+
+    /// @brief Record a sensor reading if it changed since the last one, called from the sensor controller
+    /// @param tempC The temperature in celcius
+    /// @param humidityRel The relative humidity in percent
+    static void RecordSensor(float tempC, float humidityRel);
+
+    /// @brief Record a failed sensor read, called from the sensor controller
+    static void RecordSensorError();
+
+    /// @brief Record a pin level if it changed since the last read of that pin, called from the pin controller
+    /// @param pin The pin number
+    /// @param level The level read from the pin
+    static void RecordPin(uint8_t pin, uint8_t level);
+
+    /// @brief Record a console setting change, called from the settings controller
+    /// @param kind The SettingCommandKind
+    /// @param value The new value
+    static void RecordSetting(uint8_t kind, int16_t value);
+
+    /// @brief Getter for the number of records that did not fit in the output
+    /// @return The number of lost records, a trace with lost records will not replay faithfully
+    static unsigned long LostRecords();
+
+  private:
+    /// @brief The recorder the static hooks write to
+    static InputTraceRecorder *_active;
+
+    /// @brief Where to write the trace
+    Print & _output;
+
+    /// @brief The time of the last written record
+    unsigned long _lastRecordMs = 0;
+
+    /// @brief The last recorded temperature in hundredths of a degree celcius
+    int16_t _lastTempCentiC = 0;
+
+    /// @brief The last recorded humidity in hundredths of a percent
+    uint16_t _lastHumidityCentiRel = 0;
+
+    /// @brief Flag for if a sensor reading has been recorded since the start or the last error
+    bool _hasSensorRecord = false;
+
+    /// @brief Flag for if the last sensor record was an error
+    bool _isSensorFailing = false;
+
+    /// @brief The pins being tracked, in the order they were first seen
+    uint8_t _pins[MaxPins];
+
+    /// @brief The number of pins being tracked
+    uint8_t _pinCount = 0;
+
+    /// @brief The last recorded level of each tracked pin, one bit per entry in \a _pins
+    uint8_t _pinLevels = 0;
+
+    /// @brief The number of records that did not fit in the output
+    unsigned long _lostRecords = 0;
+
+    /// @brief Write one record, or count it as lost if the output cannot take all of it right now
+    /// @param tag The record tag
+    /// @param payload The payload bytes
+    /// @param payloadSize The number of payload bytes
+    /// @return True if the record was written
+    bool _writeRecord(InputTraceTag tag, const uint8_t *payload, uint8_t payloadSize);
+};
+
+#endif
@@ -2,82 +2,79 @@
 // Created by joerr on 20-Apr-24.
 //
 #include <Arduino.h>
+#include "PinTraits.h"
+#include "InputTrace.h"
 
 #ifndef THERMOSTATIO_PINCONTROLLER_H
 #define THERMOSTATIO_PINCONTROLLER_H
 
-enum IoMode {
-  In = 0,
-  Out = 1,
-};
-
+/**
+ * A light wrapper around one pin, the pin, its mode and its inversion are template arguments so every access compiles
+ * down to the register access in \a PinTraits with nothing stored but the last value written.
+ * @tparam Pin The arduino pin number to control
+ * @tparam Mode The pin mode
+ * @tparam Inverted Whether the logic of this pin is inverted, set this if you want "on" to represent LOW and "off" to
+ * represent HIGH
+ */
+template<uint8_t Pin, uint8_t Mode, bool Inverted = false>
 class PinController {
 private:
-  /// The pin number that this controller represents
-  uint8_t _pin;
-
-  /// The mode of the pin to set during initialization
-  uint8_t _mode;
+  /// Internals of arduino default to write if the mode is bad
+  static constexpr bool _isInput = Mode == INPUT || Mode == INPUT_PULLUP;
 
-  /// Whether the logic of this pin is inverted, set this if you want "on" to represent LOW and "off" to represent HIGH
-  bool _inverted = false;
-
-  /// A higher-level in/out enum so that we can not care about comparing with mode
-  IoMode _ioMode;
-
-  /// If this is an "Out" controller, this will hold the last value we wrote to the pin
+  /// If this is an output controller, this will hold the last value we wrote to the pin
   bool _setOn = false;
 
-  /// The value to use in this controller to represent "On"
-  uint8_t _onValue() const {
-    return _inverted ? LOW : HIGH;
-  }
-
-  /// The value to use in this controller to represent "Off"
-  uint8_t _offValue() const {
-    return _inverted ? HIGH : LOW;
-  }
-
 public:
-  /**
-   * Initialize the pin controller, this is a light wrapper around the digital functions for arduino.
-   * @param pin The arduino pin number to control
-   * @param mode The pin mode
-   */
-  PinController(uint8_t pin, uint8_t mode);
-
   /**
    * You must call initialize to run the pin setup.  Output pins will be set to this controller's Off value.
    */
-  void Initialize();
-
-  /**
-   * Flip the current inversion setting
-   * @return The new inversion setting
-   */
-  bool Invert();
+  void Initialize() {
+    pinMode(Pin, Mode);
+    SetPinOff();  // ensure predictable start values
+  }
 
   /**
    * Checks if the pin set to high in write mode or if it is high in read mode
    * @return True if the pin reads on, or if the pin state is set to high in write mode
    */
-  bool IsOn();
+  bool IsOn() {
+    if (!_isInput) return _setOn;
+
+    bool isHigh = PinTraits<Pin>::Read();
+#ifdef THERMOSTAT_TRACE_RECORD
+    InputTraceRecorder::RecordPin(Pin, isHigh ? HIGH : LOW);
+#endif
+    return isHigh != Inverted;
+  }
 
   /**
    * Checks if the pin is set to low in write mode or if it is low in read mode
    * @return True if the pin reads off, or if the pin state is set to low in write mode
    */
-  bool IsOff();
+  bool IsOff() {
+    return _isInput ? PinTraits<Pin>::Read() == Inverted : !_setOn;
+  }
 
   /**
    * Sets the pin to high in write mode, otherwise no action
    */
-  void SetPinOn();
+  void SetPinOn() {
+    if (_isInput) return;
+
+    _setOn = true;
+    PinTraits<Pin>::Write(!Inverted);
+  }
 
   /**
    * Sets the pin to low in write mode, otherwise no action
    */
-  void SetPinOff();
+  void SetPinOff() {
+    if (_isInput) return;
+
+    _setOn = false;
+    PinTraits<Pin>::Write(Inverted);
+  }
 };
 
 #endif //THERMOSTATIO_PINCONTROLLER_H
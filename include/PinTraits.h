@@ -0,0 +1,74 @@
+#include <Arduino.h>
+
+#ifndef THERMOSTATIO_PINTRAITS_H
+#define THERMOSTATIO_PINTRAITS_H
+
+/*
+ * Register access for a pin number known at compile time.  Where the register and bit of a pin can be worked out at
+ * compile time a read or write is a single register access, everywhere else it falls back to the core's
+ * digitalRead/digitalWrite and their pin table lookups.
+ */
+
+#if defined(CONFIG_IDF_TARGET_ESP32S2)
+#include <soc/gpio_reg.h>
+
+/// ESP32-S2: every GPIO is a bit in one of two banks, pins 0-31 and 32-53, with write-one-to-set and clear registers
+template<uint8_t Pin>
+struct PinTraits {
+  /// The bit of the pin in its bank
+  static constexpr uint32_t Mask = 1UL << (Pin & 31);
+
+  /// Read the input level of the pin
+  static bool Read() {
+    return (REG_READ(Pin < 32 ? GPIO_IN_REG : GPIO_IN1_REG) & Mask) != 0;
+  }
+
+  /// Drive the pin high or low
+  static void Write(bool isHigh) {
+    if (Pin < 32)
+      REG_WRITE(isHigh ? GPIO_OUT_W1TS_REG : GPIO_OUT_W1TC_REG, Mask);
+    else
+      REG_WRITE(isHigh ? GPIO_OUT1_W1TS_REG : GPIO_OUT1_W1TC_REG, Mask);
+  }
+};
+
+#else
+
+/// Any pin without a specialization goes through the core
+template<uint8_t Pin>
+struct PinTraits {
+  /// Read the input level of the pin
+  static bool Read() {
+    return digitalRead(Pin) == HIGH;
+  }
+
+  /// Drive the pin high or low
+  static void Write(bool isHigh) {
+    digitalWrite(Pin, isHigh ? HIGH : LOW);
+  }
+};
+
+#if defined(__AVR_ATmega32U4__)
+/// ATmega32U4 (micro): a pin is a bit of one port, the compiler turns these into single sbi/cbi/sbic instructions
+#define THERMOSTAT_AVR_PIN_TRAITS(pin, port, bit)                                   \
+  template<>                                                                        \
+  struct PinTraits<pin> {                                                           \
+    static constexpr uint8_t Mask = _BV(bit);                                       \
+    static bool Read() { return (PIN##port & Mask) != 0; }                          \
+    static void Write(bool isHigh) { if (isHigh) PORT##port |= Mask; else PORT##port &= ~Mask; } \
+  };
+
+THERMOSTAT_AVR_PIN_TRAITS(4, D, 4)
+THERMOSTAT_AVR_PIN_TRAITS(5, C, 6)
+THERMOSTAT_AVR_PIN_TRAITS(6, D, 7)
+THERMOSTAT_AVR_PIN_TRAITS(18, F, 7)
+THERMOSTAT_AVR_PIN_TRAITS(19, F, 6)
+THERMOSTAT_AVR_PIN_TRAITS(20, F, 5)
+THERMOSTAT_AVR_PIN_TRAITS(21, F, 4)
+
+#undef THERMOSTAT_AVR_PIN_TRAITS
+#endif
+
+#endif
+
+#endif //THERMOSTATIO_PINTRAITS_H
@@ -0,0 +1,107 @@
+#include <Arduino.h>
+
+#ifndef RECOVERY_MODEL_H
+#define RECOVERY_MODEL_H
+
+/// @brief The direction the equipment moves the temperature
+enum RecoveryDirection : uint8_t {
+  RecoveryHeat = 0,
+  RecoveryCool = 1,
+};
+
+/// @brief Learns how the room responds to the heating and cooling system from the cycles it sees: the temperature
+/// rate while running, the undershoot after a start (the temperature keeps drifting until the equipment warms up) and
+/// the overshoot after a stop (the coast down).  Each is an exponentially weighted average over cycles, updated with
+/// integer math once per HVAC decision.  Cooling is tracked on the negated temperature so both directions share the
+/// same code, every value is positive in the direction of the equipment.
+class RecoveryModel {
+  public:
+    /// @brief The shortest run, from the lowest point after the start, that a rate is learned from
+    static constexpr unsigned long MinRateRunMs = 180000UL;  // 3 minutes
+
+    /// @brief The longest a coast down is followed after a stop
+    static constexpr unsigned long MaxCoastMs = 1200000UL;  // 20 minutes
+
+    /// @brief The fall from the peak after a stop at which the coast down counts as over
+    static constexpr int16_t CoastEndCentiC = 20;
+
+    /// @brief Account one HVAC decision
+    /// @param isHeatOn The heating relay state the last decision left
+    /// @param isCoolOn The cooling relay state the last decision left
+    /// @param tempCentiC The temperature in hundredths of a degree celcius
+    /// @param nowMs The current time
+    void Update(bool isHeatOn, bool isCoolOn, int16_t tempCentiC, unsigned long nowMs);
+
+    /// @brief Getter for the learned rate while running
+    /// @param direction Heating or cooling
+    /// @return The temperature change per hour in hundredths of a degree celcius, 0 until learned
+    int16_t RateCentiCPerHour(RecoveryDirection direction) const;
+
+    /// @brief Getter for the learned drift past the start point after the equipment starts
+    /// @param direction Heating or cooling
+    /// @return The undershoot in hundredths of a degree celcius, 0 until learned
+    int16_t UndershootCentiC(RecoveryDirection direction) const;
+
+    /// @brief Getter for the learned drift past the stop point after the equipment stops
+    /// @param direction Heating or cooling
+    /// @return The overshoot in hundredths of a degree celcius, 0 until learned
+    int16_t OvershootCentiC(RecoveryDirection direction) const;
+
+    /// @brief Getter for the number of cycles learned from
+    /// @param direction Heating or cooling
+    /// @return The cycles, saturates at 255
+    uint8_t LearnedCycles(RecoveryDirection direction) const;
+
+  private:
+    /// @brief What the model is following
+    enum Phase : uint8_t {
+      Idle = 0,
+      Running = 1,
+      Coasting = 2,
+    };
+
+    /// @brief The learned rates, indexed by direction
+    int16_t _rateCentiCPerHour[2] = {0, 0};
+
+    /// @brief The learned undershoots, indexed by direction
+    int16_t _undershootCentiC[2] = {0, 0};
+
+    /// @brief The learned overshoots, indexed by direction
+    int16_t _overshootCentiC[2] = {0, 0};
+
+    /// @brief The cycles learned from, indexed by direction
+    uint8_t _learnedCycles[2] = {0, 0};
+
+    /// @brief Which averages have a first sample, bit 0 to 2 rate, undershoot and overshoot of heating, bit 3 to 5
+    /// the same for cooling
+    uint8_t _learnedMask = 0;
+
+    /// @brief What is being followed
+    Phase _phase = Idle;
+
+    /// @brief The direction being followed
+    RecoveryDirection _direction = RecoveryHeat;
+
+    /// @brief The temperature in the direction being followed at the start or stop
+    int16_t _referenceCentiC = 0;
+
+    /// @brief The lowest temperature in the direction being followed since the start, or the highest since the stop
+    int16_t _extremeCentiC = 0;
+
+    /// @brief The time of the start or stop
+    unsigned long _phaseStartMs = 0;
+
+    /// @brief The time of the lowest temperature since the start
+    unsigned long _extremeMs = 0;
+
+    /// @brief Fold a sample into an average, the first sample is taken as is
+    /// @param average The average to update
+    /// @param sample The new sample
+    /// @param bit The bit of the average in \a _learnedMask
+    void _learn(int16_t & average, int16_t sample, uint8_t bit);
+
+    /// @brief Start following a run
+    void _startRun(RecoveryDirection direction, int16_t tempCentiC, unsigned long nowMs);
+};
+
+#endif
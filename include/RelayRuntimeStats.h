@@ -0,0 +1,81 @@
+#include <Arduino.h>
+
+#ifndef RELAY_RUNTIME_STATS_H
+#define RELAY_RUNTIME_STATS_H
+
+/// @brief The lifetime counters of one relay, plain data so it can be persisted as is
+struct RelayRuntimeTotals {
+  /// @brief The total time of completed runs in seconds
+  uint32_t onSeconds;
+
+  /// @brief The number of times the relay turned on
+  uint32_t cycles;
+
+  /// @brief The longest completed run in seconds
+  uint32_t longestRunSeconds;
+
+  /// @brief The shortest completed run in seconds, 0 until a run completes
+  uint32_t shortestRunSeconds;
+};
+
+/// @brief Runtime and cycle accounting for one relay.  Everything is updated when the relay changes state, so the only
+/// cost of a relay write that changes nothing is one compare.  Cycles per hour are counted in quarter hour buckets,
+/// the rolling window is the current quarter hour and the three before it.
+class RelayRuntimeStats {
+  public:
+    /// @brief The number of buckets in the cycles per hour window
+    static constexpr uint8_t WindowBuckets = 4;
+
+    /// @brief The span of one bucket
+    static constexpr unsigned long BucketMs = 900000UL;  // 15 minutes
+
+    /// @brief Account a relay write
+    /// @param isOn The state written to the relay
+    /// @param nowMs The current time
+    /// @return True if the relay changed state
+    bool Update(bool isOn, unsigned long nowMs);
+
+    /// @brief Getter for the relay state
+    /// @return True if the relay is on
+    bool IsOn() const;
+
+    /// @brief Getter for the lifetime counters, these only include completed runs
+    /// @return The counters
+    const RelayRuntimeTotals & Totals() const;
+
+    /// @brief Getter for the total on time including a run in progress
+    /// @param nowMs The current time
+    /// @return The on time in seconds
+    uint32_t OnSeconds(unsigned long nowMs) const;
+
+    /// @brief Getter for the number of times the relay turned on over the last hour
+    /// @param nowMs The current time
+    /// @return The number of cycles in the window
+    uint16_t CyclesPerHour(unsigned long nowMs) const;
+
+    /// @brief Continue counting from previously saved counters
+    /// @param totals The saved counters
+    void Restore(const RelayRuntimeTotals & totals);
+
+  private:
+    /// @brief The lifetime counters
+    RelayRuntimeTotals _totals = {0, 0, 0, 0};
+
+    /// @brief The last state written to the relay
+    bool _isOn = false;
+
+    /// @brief The time the current run started
+    unsigned long _onSinceMs = 0;
+
+    /// @brief The cycle starts per quarter hour, indexed by quarter hour number modulo the bucket count
+    uint16_t _bucketCycles[WindowBuckets] = {0};
+
+    /// @brief The quarter hour number of the newest bucket
+    unsigned long _newestQuarter = 0;
+
+    /// @brief Count a cycle start in its quarter hour bucket, clearing buckets that fell out of the window
+    /// @param nowMs The current time
+    void _countCycleStart(unsigned long nowMs);
+};
+
+#endif
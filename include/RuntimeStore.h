@@ -0,0 +1,43 @@
+#include <Arduino.h>
+#include "RelayRuntimeStats.h"
+
+#ifndef RUNTIME_STORE_H
+#define RUNTIME_STORE_H
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+#if !defined(ARDUINO_ARCH_AVR) && !defined(ARDUINO_ARCH_ESP32)
+#error "THERMOSTAT_PERSIST_RUNTIME needs EEPROM, only the AVR and ESP32 cores have it"
+#endif
+
+/// @brief Saves the relay runtime counters to EEPROM (flash backed on the ESP32) so they survive a power cycle.  The
+/// block is tagged with a magic number and the relay count, anything else found there is ignored.
+class RuntimeStore {
+  public:
+    /// @brief Load saved counters
+    /// @param totals The counters to fill in, left alone if nothing valid is saved
+    /// @param count The number of relays
+    /// @return True if saved counters were loaded
+    static bool Load(RelayRuntimeTotals *totals, uint8_t count);
+
+    /// @brief Save the counters, only bytes that changed are written
+    /// @param totals The counters to save
+    /// @param count The number of relays
+    static void Save(const RelayRuntimeTotals *totals, uint8_t count);
+
+  private:
+    /// @brief Marks a block written by this store
+    static constexpr uint16_t _magic = 0x5254;  // "RT"
+
+    /// @brief The EEPROM address of the block
+    static constexpr int _address = 0;
+
+    /// @brief The most relays a block holds, sizes the emulated EEPROM on the ESP32
+    static constexpr uint8_t _maxCount = 3;
+
+    /// @brief Start the emulated EEPROM on cores that need it
+    static void _beginEeprom();
+};
+
+#endif
+
+#endif
@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include "SHT31.h"
+
+#ifndef SHT31_PERIODIC_H
+#define SHT31_PERIODIC_H
+
+/// @brief How repeatable periodic measurements are, higher repeatability takes longer to convert and draws more power
+enum SHT31Repeatability : uint8_t {
+  SHT31RepeatabilityHigh = 0,
+  SHT31RepeatabilityMedium = 1,
+  SHT31RepeatabilityLow = 2,
+};
+
+/// @brief How many measurements per second the sensor takes in periodic mode
+enum SHT31Rate : uint8_t {
+  SHT31RateHalf = 0,  // 0.5 per second
+  SHT31Rate1 = 1,
+  SHT31Rate2 = 2,
+  SHT31Rate4 = 3,
+  SHT31Rate10 = 4,
+};
+
+/// @brief SHT31 with the periodic data acquisition mode.  The sensor converts on its own at a fixed rate and a read is
+/// only the fetch command and six bytes, with no conversion wait.  A fetch with no new measurement since the last one
+/// is not acknowledged, so read no faster than the measurement rate.
+class SHT31Periodic : public SHT31 {
+  public:
+    using SHT31::SHT31;
+
+    /// @brief Start periodic acquisition, the first result is ready one measurement period later
+    /// @param repeatability The repeatability of each measurement
+    /// @param rate The measurements per second
+    /// @return True if the sensor accepted the command
+    bool StartPeriodic(SHT31Repeatability repeatability, SHT31Rate rate);
+
+    /// @brief Fetch the latest periodic measurement, checked against its CRC
+    /// @return True if a new measurement was read
+    bool FetchData();
+
+    /// @brief Stop periodic acquisition and return the sensor to single-shot mode
+    /// @return True if the sensor accepted the command
+    bool StopPeriodic();
+
+    /// @brief Check if periodic acquisition was started
+    /// @return True if the sensor is in periodic mode
+    bool IsPeriodic() const;
+
+  private:
+    /// @brief Flag for if periodic acquisition was started
+    bool _isPeriodic = false;
+};
+
+#endif
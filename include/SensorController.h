@@ -1,5 +1,9 @@
 #include "StableDebouncer.h"
-#include "SHT31.h"
+#include "ComfortMetrics.h"
+#include "TemperatureConverter.h"
+#include "InputTrace.h"
+#include "I2cArbiter.h"
+#include "SHT31Periodic.h"
 
 #ifndef SENSOR_CONTROLLER_H
 #define SENSOR_CONTROLLER_H
@@ -11,20 +15,160 @@ class SensorController {
     StableDebouncer _readSensorDebouncer;
 
     /// @brief The sensor object
-    SHT31 _sensor;
+    SHT31Periodic _sensor;
+
+    /// @brief Flag for if reads use periodic acquisition instead of single-shot measurements
+    bool _isPeriodicMode = false;
+
+    /// @brief The repeatability of periodic measurements
+    SHT31Repeatability _periodicRepeatability = SHT31RepeatabilityHigh;
+
+    /// @brief The rate of periodic measurements
+    SHT31Rate _periodicRate = SHT31Rate2;
+
+    /// @brief The number of times a periodic fetch failed and the read fell back to single-shot
+    unsigned long _periodicFallbackCount = 0;
+
+    /// @brief The arbiter for the bus the sensor is on, used to share the bus and recover it when stuck, may be null
+    I2cArbiter *_arbiter = nullptr;
+
+    /// @brief The time of the last successful read
+    unsigned long _lastGoodReadMs = 0;
+
+    /// @brief Flag for if any read has succeeded
+    bool _hasGoodRead = false;
+
+    /// @brief How long a reading stays valid without a successful read
+    unsigned long _staleAfterMs = 5000;
+
+    /// @brief The number of failed reads in a row before the bus is recovered and the sensor re-initialized
+    uint8_t _recoverAfterErrors = 3;
+
+    /// @brief The number of failed reads in a row
+    uint8_t _consecutiveErrors = 0;
+
+    /// @brief The total number of failed reads
+    unsigned long _errorCount = 0;
+
+    /// @brief The number of times the sensor was re-initialized after errors
+    unsigned long _reinitCount = 0;
 
     /// @brief The last read temperature value in celcius
     float _currentTempC;
 
     /// @brief The last read humidity in relative percent
     float _currentHumdityRel;
+
+    /// @brief The dew point derived from the last reading in celcius
+    float _currentDewPointC;
+
+    /// @brief The absolute humidity derived from the last reading in grams per cubic meter
+    float _currentAbsoluteHumidity;
+
+    /// @brief The heat index derived from the last reading in celcius
+    float _currentHeatIndexC;
+
+    /// @brief The last read temperature in tenths of a degree celcius, for table driven display conversion
+    int16_t _currentTempTenthsC = 0;
+
+    /// @brief The dew point in tenths of a degree celcius
+    int16_t _currentDewPointTenthsC = 0;
+
+    /// @brief The heat index in tenths of a degree celcius
+    int16_t _currentHeatIndexTenthsC = 0;
     
+    /// @brief Count a failed read, recovering the bus and re-initializing the sensor after too many in a row
+    void _handleReadError() {
+      _errorCount++;
+
+      if(++_consecutiveErrors < _recoverAfterErrors)
+        return;
+
+      // back to single-shot, periodic acquisition starts again after the next good read
+      if(_arbiter)
+        _arbiter->Transact(SensorClient, [this]() { _arbiter->Bus().Recover(); _sensor.StopPeriodic(); _sensor.begin(); });
+      else {
+        _sensor.StopPeriodic();
+        _sensor.begin();
+      }
+
+      _consecutiveErrors = 0;
+      _reinitCount++;
+    }
+
+    /// @brief Read the sensor, in periodic mode this is a fetch with a single-shot read to fall back on.  Periodic
+    /// acquisition is started after a good single-shot read, so the sensor is never left waiting for its first result.
+    /// @return True if the read succeeded
+    bool _sensorRead() {
+      if(!_isPeriodicMode) {
+        // switched back to single-shot while periodic acquisition was running
+        if(_sensor.IsPeriodic()) {
+          _sensor.StopPeriodic();
+          delayMicroseconds(1000);
+        }
+
+        return _sensor.read();
+      }
+
+      if(_sensor.IsPeriodic()) {
+        if(_sensor.FetchData())
+          return true;
+
+        // the sensor must be out of periodic mode for a millisecond before it takes a single-shot command
+        _periodicFallbackCount++;
+        _sensor.StopPeriodic();
+        delayMicroseconds(1000);
+      }
+
+      if(!_sensor.read())
+        return false;
+
+      _sensor.StartPeriodic(_periodicRepeatability, _periodicRate);
+      return true;
+    }
+
+    /// @brief Read the sensor through the arbiter when there is one
+    /// @return True if the read succeeded
+    bool _transactRead() {
+      bool isRead = false;
+
+      if(_arbiter)
+        _arbiter->Transact(SensorClient, [this, &isRead]() { isRead = _sensorRead(); });
+      else
+        isRead = _sensorRead();
+
+      return isRead;
+    }
+
     /// @brief Execute a read of the sensor
     void _readSensor() {
-      _sensor.read();
+      if(!_transactRead()) {
+#ifdef THERMOSTAT_TRACE_RECORD
+        InputTraceRecorder::RecordSensorError();
+#endif
+        _handleReadError();
+        return;
+      }
+
+      _consecutiveErrors = 0;
+      _hasGoodRead = true;
+      _lastGoodReadMs = millis();
 
       _currentTempC = _sensor.getTemperature();
       _currentHumdityRel = _sensor.getHumidity();
+
+#ifdef THERMOSTAT_TRACE_RECORD
+      InputTraceRecorder::RecordSensor(_currentTempC, _currentHumdityRel);
+#endif
+
+      _currentDewPointC = ComfortMetrics::DewPointC(_currentTempC, _currentHumdityRel);
+      _currentAbsoluteHumidity = ComfortMetrics::AbsoluteHumidity(_currentTempC, _currentHumdityRel);
+      _currentHeatIndexC = ComfortMetrics::HeatIndexC(_currentTempC, _currentHumdityRel);
+
+      // round once per sample so every display frame is pure table lookups
+      _currentTempTenthsC = TemperatureConverter::ToTenthsC(_currentTempC);
+      _currentDewPointTenthsC = TemperatureConverter::ToTenthsC(_currentDewPointC);
+      _currentHeatIndexTenthsC = TemperatureConverter::ToTenthsC(_currentHeatIndexC);
     }
 
   public:
@@ -36,6 +180,61 @@ class SensorController {
     /// @return The last read humidity in relative percent
     float CurrentHumidityRel() const;
 
+    /// @brief Getter of the current dew point
+    /// @return The dew point of the last reading in celcius
+    float CurrentDewPointC() const;
+
+    /// @brief Getter of the current absolute humidity
+    /// @return The absolute humidity of the last reading in grams per cubic meter
+    float CurrentAbsoluteHumidity() const;
+
+    /// @brief Getter of the current heat index
+    /// @return The apparent temperature of the last reading in celcius
+    float CurrentHeatIndexC() const;
+
+    /// @brief Getter of the current temperature in tenths
+    /// @return The last read temperature in tenths of a degree celcius
+    int16_t CurrentTempTenthsC() const;
+
+    /// @brief Getter of the current dew point in tenths
+    /// @return The dew point of the last reading in tenths of a degree celcius
+    int16_t CurrentDewPointTenthsC() const;
+
+    /// @brief Getter of the current heat index in tenths
+    /// @return The apparent temperature of the last reading in tenths of a degree celcius
+    int16_t CurrentHeatIndexTenthsC() const;
+
+    /// @brief Check if the current reading can be trusted
+    /// @return True if a read has succeeded within the staleness window
+    bool IsReadingValid() const;
+
+    /// @brief Getter for the total number of failed reads
+    /// @return The number of failed reads
+    unsigned long ErrorCount() const;
+
+    /// @brief Getter for the number of sensor re-initializations
+    /// @return The number of times the bus was recovered and the sensor re-initialized
+    unsigned long ReinitCount() const;
+
+    /// @brief Set how reads that fail are handled
+    /// @param arbiter The arbiter reads go through and whose bus is recovered when reads keep failing, may be null
+    /// @param staleAfterMs How long a reading stays valid without a successful read
+    /// @param recoverAfterErrors The number of failed reads in a row before recovery
+    void SetErrorHandling(I2cArbiter *arbiter, unsigned long staleAfterMs, uint8_t recoverAfterErrors);
+
+    /// @brief Getter for the number of periodic fetches that fell back to single-shot
+    /// @return The number of fallbacks
+    unsigned long PeriodicFallbackCount() const;
+
+    /// @brief Read with the sensor's periodic data acquisition mode, each read is then only a fetch with no conversion
+    /// wait.  Keep the read interval no shorter than the measurement period or fetches will find no new data.
+    /// @param repeatability The repeatability of each measurement
+    /// @param rate The measurements per second
+    void SetPeriodicMode(SHT31Repeatability repeatability, SHT31Rate rate);
+
+    /// @brief Read with single-shot measurements, this is the default
+    void SetSingleShotMode();
+
     /// @brief The current sensor object being managed by this object
     /// @return The SHT31 sensor
     SHT31 & Sensor();
@@ -0,0 +1,103 @@
+#include <Arduino.h>
+
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+/// @brief The tokens of one console line.  Tokens point into the console's line buffer, nothing is copied.
+class ConsoleArguments {
+  public:
+    /// @brief The most tokens a line can be split into, including the command name
+    static constexpr uint8_t MaxTokens = 4;
+
+    /// @brief Getter for the number of tokens on the line
+    /// @return The number of tokens, including the command name
+    uint8_t Count() const;
+
+    /// @brief Getter for a token
+    /// @param index The token index, 0 is the command name
+    /// @return The token, or an empty string when there is no such token
+    const char* Get(uint8_t index) const;
+
+    /// @brief Compare a token against a PROGMEM string
+    /// @param index The token index, 0 is the command name
+    /// @param value The PROGMEM string to compare with, use PSTR()
+    /// @return True if the token exists and matches
+    bool Is(uint8_t index, const char *value) const;
+
+    /// @brief Parse a token as a decimal number with at most one fractional digit
+    /// @param index The token index
+    /// @param tenths Set to the value in tenths on success
+    /// @return True if the token was a valid number
+    bool ParseTenths(uint8_t index, int16_t & tenths) const;
+
+  private:
+    friend class SerialConsole;
+
+    /// @brief Pointers into the line buffer for each token
+    const char *_tokens[MaxTokens] = {nullptr};
+
+    /// @brief The number of tokens found
+    uint8_t _count = 0;
+};
+
+/// @brief One entry of a console command table, both the table and the names should live in PROGMEM
+struct ConsoleCommand {
+  /// @brief The command name, a PROGMEM string
+  const char *name;
+
+  /// @brief The function to run for the command
+  void (*handler)(const ConsoleArguments & args, Print & out);
+};
+
+/// @brief Line based serial command console.  Input is consumed incrementally, a bounded number of bytes per loop,
+/// into a fixed buffer and dispatched through a compile-time command table, so it never allocates or stalls the loop.
+class SerialConsole {
+  public:
+    /// @brief The longest line accepted, including the terminator
+    static constexpr uint8_t BufferSize = 40;
+
+    /// @brief Constructor for the console
+    /// @param input The stream to read commands from
+    /// @param output Where command responses are written
+    /// @param commands The PROGMEM command table
+    /// @param commandCount The number of entries in \p commands
+    /// @param maxBytesPerLoop The most input bytes consumed by a single call to \a LoopHandler
+    SerialConsole(Stream & input, Print & output, const ConsoleCommand *commands, uint8_t commandCount,
+                  uint8_t maxBytesPerLoop);
+
+    /// @brief Print the name of every command in the table
+    void PrintCommands();
+
+    /// @brief Handler for executing looping behavior, reads pending input and runs at most one command
+    void LoopHandler();
+
+  private:
+    /// @brief The stream to read commands from
+    Stream & _input;
+
+    /// @brief Where command responses are written
+    Print & _output;
+
+    /// @brief The PROGMEM command table
+    const ConsoleCommand *_commands;
+
+    /// @brief The number of entries in the command table
+    uint8_t _commandCount;
+
+    /// @brief The most input bytes consumed per loop
+    uint8_t _maxBytesPerLoop;
+
+    /// @brief The line being assembled
+    char _buffer[BufferSize];
+
+    /// @brief The number of characters in the line so far
+    uint8_t _length = 0;
+
+    /// @brief Flag for a line that ran past the buffer, the rest of it is discarded
+    bool _isOverflowed = false;
+
+    /// @brief Split the buffer into tokens in place and run the matching command
+    void _dispatch();
+};
+
+#endif
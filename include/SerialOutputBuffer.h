@@ -0,0 +1,84 @@
+#include <Arduino.h>
+
+#ifndef SERIAL_OUTPUT_BUFFER_H
+#define SERIAL_OUTPUT_BUFFER_H
+
+/// @brief What to throw away when the output buffer is full
+enum SerialOverflowPolicy : uint8_t {
+  DropNewest = 0,  // keep what is already queued and discard the bytes being written
+  DropOldest = 1,  // discard the oldest queued bytes to make room for the bytes being written
+};
+
+/// @brief A Print that formats into a fixed ring buffer and only hands the underlying output as many bytes as it
+/// reports it can take without blocking.  Writers never wait on the UART, when the buffer is full bytes are dropped
+/// according to the overflow policy and counted.
+class SerialOutputBuffer : public Print {
+  public:
+#ifdef THERMOSTAT_MEMORY_LEAN
+    /// @brief The number of bytes that can be queued
+    static constexpr uint16_t BufferSize = 96;
+#else
+    /// @brief The number of bytes that can be queued
+    static constexpr uint16_t BufferSize = 256;
+#endif
+
+    /// @brief Constructor for the output buffer
+    /// @param output The output to drain into, this must report \a availableForWrite
+    /// @param policy What to do when the buffer is full
+    SerialOutputBuffer(Print & output, SerialOverflowPolicy policy);
+
+    /// @brief Queue a byte
+    /// @param value The byte to queue
+    /// @return 1, bytes dropped by the overflow policy still count as written so callers never retry
+    size_t write(uint8_t value) override;
+
+    /// @brief Queue a run of bytes
+    /// @param buffer The bytes to queue
+    /// @param size The number of bytes
+    /// @return \p size, bytes dropped by the overflow policy still count as written so callers never retry
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+    using Print::write;
+
+    /// @brief Getter for the free space in the buffer
+    /// @return The number of bytes that can be written without dropping anything
+    int availableForWrite() override;
+
+    /// @brief Getter for the number of bytes dropped since the last counter reset
+    /// @return The number of dropped bytes
+    unsigned long DroppedBytes() const;
+
+    /// @brief Getter for the most bytes queued at once since the last counter reset
+    /// @return The high water mark in bytes
+    uint16_t HighWaterMark() const;
+
+    /// @brief Reset the dropped byte counter and the high water mark
+    void ResetCounters();
+
+    /// @brief Handler for executing looping behavior, drains what the output can take right now
+    void LoopHandler();
+
+  private:
+    /// @brief The output to drain into
+    Print & _output;
+
+    /// @brief What to do when the buffer is full
+    SerialOverflowPolicy _policy;
+
+    /// @brief The queued bytes
+    uint8_t _buffer[BufferSize];
+
+    /// @brief The index of the oldest queued byte
+    uint16_t _head = 0;
+
+    /// @brief The number of queued bytes
+    uint16_t _count = 0;
+
+    /// @brief The most bytes queued at once
+    uint16_t _highWaterMark = 0;
+
+    /// @brief The number of bytes dropped by the overflow policy
+    unsigned long _droppedBytes = 0;
+};
+
+#endif
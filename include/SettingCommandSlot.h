@@ -0,0 +1,60 @@
+#include <Arduino.h>
+
+#ifndef SETTING_COMMAND_SLOT_H
+#define SETTING_COMMAND_SLOT_H
+
+/// @brief The settings the serial console can change
+enum SettingCommandKind : uint8_t {
+  SettingHeatSetpoint = 1,  // value in tenths of a degree celcius
+  SettingCoolSetpoint = 2,  // value in tenths of a degree celcius
+  SettingHeatMode = 3,      // value is a ThermostatHvacMode
+  SettingTempMode = 4,      // value is a ThermostatTemperatureMode
+};
+
+/// @brief One setting change from the serial console
+struct SettingCommand {
+  /// @brief The setting to change
+  SettingCommandKind kind;
+
+  /// @brief The new value
+  int16_t value;
+};
+
+/// @brief Single slot hand off of console setting changes from the UI side to the control side, so the settings are
+/// only ever written from the control step.  The UI posts into an empty slot, the control side takes it and counts it,
+/// and the UI knows a change has been applied once the taken count in a snapshot reaches the posted count.
+class SettingCommandSlot {
+  public:
+    /// @brief Post a change, only ever call this from the UI side
+    /// @param command The change
+    /// @return False if the last change has not been taken yet
+    bool Post(const SettingCommand & command);
+
+    /// @brief Take the posted change, only ever call this from the control side
+    /// @param command The change to fill in
+    /// @return True if there was a change
+    bool Take(SettingCommand & command);
+
+    /// @brief Getter for the number of changes posted, wraps
+    /// @return The count
+    uint16_t PostedCount() const;
+
+    /// @brief Getter for the number of changes taken, wraps
+    /// @return The count
+    uint16_t TakenCount() const;
+
+  private:
+    /// @brief The posted change
+    SettingCommand _command = SettingCommand();
+
+    /// @brief Flag for if the slot holds a change the control side has not taken
+    volatile bool _isFull = false;
+
+    /// @brief The number of changes posted
+    uint16_t _postedCount = 0;
+
+    /// @brief The number of changes taken
+    volatile uint16_t _takenCount = 0;
+};
+
+#endif
@@ -1,6 +1,9 @@
 #include "ThermostatModes.h"
 #include "StableDebouncer.h"
-#include "PinController.h"
+#include "BoardPins.h"
+#include "HoldAcceleration.h"
+#include "TemperatureConverter.h"
+#include "SettingCommandSlot.h"
 
 #ifndef SETTINGSCONTROLLER_H
 #define SETTINGSCONTROLLER_H
@@ -11,18 +14,46 @@ class SettingsController {
     StableDebouncer _incrementBouncer;
     StableDebouncer _decrementBouncer;
     StableDebouncer _setHeatModeBouncer = StableDebouncer();
-    PinController _upButton;
-    PinController _downButton;
-    PinController _modeButton;
+    StableDebouncer _setTempModeBouncer = StableDebouncer();
+    UpButtonPin _upButton;
+    DownButtonPin _downButton;
+    HeatModeButtonPin _modeButton;
+    TempModeButtonPin _tempModeButton;
 
-    /// @brief The temperature target for heating mode when the thermostat is in celcius mode
-    float _setHeatTempC = 21.0;
+    /// @brief The pressed state of each button on the last pass, one bit per button
+    uint8_t _buttonLevels = 0;
 
-    /// @brief The temperature target for cooling mode when the thermostat is in celcius mode
-    float _setCoolTempC = 21.0;
+    /// @brief The number of button presses and releases seen, wraps
+    uint16_t _inputEdgeCount = 0;
 
-    /// @brief The amount to increment temperature settings by when in celcius mode
-    float _tempIncrementC = 0.5;
+    /// @brief Flag for if button presses only count as input and change nothing, set from the UI side
+    volatile bool _isInputLocked = false;
+
+    /// @brief Flag for if the buttons are ignored until every one is released, set by a press while input is locked
+    bool _isPressIgnored = false;
+
+    /// @brief Press-and-hold acceleration for the up button
+    HoldAcceleration _incrementAcceleration;
+
+    /// @brief Press-and-hold acceleration for the down button
+    HoldAcceleration _decrementAcceleration;
+
+    /// @brief The number of increments the next up step applies, set from the acceleration curve
+    uint8_t _incrementMultiplier = 1;
+
+    /// @brief The number of increments the next down step applies, set from the acceleration curve
+    uint8_t _decrementMultiplier = 1;
+
+    /// @brief The temperature target for heating mode in tenths of a degree celcius, this is stored in celcius
+    /// whatever the display mode is
+    int16_t _setHeatTenthsC = 210;
+
+    /// @brief The temperature target for cooling mode in tenths of a degree celcius
+    int16_t _setCoolTenthsC = 210;
+
+    /// @brief The amount a celcius mode step moves a setpoint, in tenths of a degree celcius.  Farenheit mode steps
+    /// whole degrees farenheit instead.
+    int16_t _tempIncrementTenthsC = 5;
 
     /// @brief The current temperatur display mode
     ThermostatTemperatureMode _tempMode = C;
@@ -30,14 +61,36 @@ class SettingsController {
     /// @brief The current HVAC mode
     ThermostatHvacMode _heatMode = Off;
 
-    /// @brief Increment the correct temperature setting in celcius mode
+    /// @brief Step a setpoint in the current temperature mode, farenheit steps land on whole degrees.  The result
+    /// is kept within the farenheit setpoint range in either mode.
+    /// @param setTenthsC The current setpoint in tenths of a degree celcius
+    /// @param steps The number of increments to step, negative to step down
+    /// @return The new setpoint in tenths of a degree celcius
+    int16_t _stepSetTenthsC(int16_t setTenthsC, int8_t steps) const {
+      if(_tempMode == F)
+        return TemperatureConverter::WholeFToTenthsC(TemperatureConverter::NearestWholeF(setTenthsC) + steps);
+
+      return _clampSetTenthsC(setTenthsC + steps * _tempIncrementTenthsC);
+    }
+
+    /// @brief Keep a setpoint within the farenheit setpoint range
+    /// @param setTenthsC The setpoint in tenths of a degree celcius
+    /// @return The clamped setpoint in tenths of a degree celcius
+    static int16_t _clampSetTenthsC(int16_t setTenthsC) {
+      int16_t minTenthsC = TemperatureConverter::WholeFToTenthsC(TemperatureConverter::SetpointMinF);
+      int16_t maxTenthsC = TemperatureConverter::WholeFToTenthsC(TemperatureConverter::SetpointMaxF);
+
+      return setTenthsC < minTenthsC ? minTenthsC : (setTenthsC > maxTenthsC ? maxTenthsC : setTenthsC);
+    }
+
+    /// @brief Increment the correct temperature setting
     void _incrementSetTempC() {
       switch(_heatMode) {
         case Heat:
-          _setHeatTempC += _tempIncrementC;
+          _setHeatTenthsC = _stepSetTenthsC(_setHeatTenthsC, _incrementMultiplier);
           break;
         case Cool: 
-          _setCoolTempC += _tempIncrementC;
+          _setCoolTenthsC = _stepSetTenthsC(_setCoolTenthsC, _incrementMultiplier);
           break;
         case Off:
         default:
@@ -45,14 +98,14 @@ class SettingsController {
       }
     }
 
-    /// @brief decrement the correct temperature setting in celcius mode
+    /// @brief decrement the correct temperature setting
     void _decrementSetTempC() {
       switch(_heatMode) {
         case Heat:
-          _setHeatTempC -= _tempIncrementC;
+          _setHeatTenthsC = _stepSetTenthsC(_setHeatTenthsC, -_decrementMultiplier);
           break;
         case Cool: 
-          _setCoolTempC -= _tempIncrementC;
+          _setCoolTenthsC = _stepSetTenthsC(_setCoolTenthsC, -_decrementMultiplier);
           break;
         case Off:
         default:
@@ -60,6 +113,11 @@ class SettingsController {
       }
     }
 
+    /// @brief Toggle the temperature display mode: C -> F -> C
+    void _tempModeToggle() {
+      _tempMode = _tempMode == C ? F : C;
+    }
+
     /// @brief Toggle the current heat mode: Off -> Heat -> Cool -> Off
     void _heatModeToggle() {
       switch(_heatMode) {
@@ -77,14 +135,26 @@ class SettingsController {
     }
 
   public:
-    /// @brief Getter for the current temperature target in heat mode in celcius mode
+    /// @brief Getter for the current temperature target in heat mode, whatever the display mode is
     /// @return The current temperature target in celcius
     float SetHeatTempC() const;
 
-    /// @brief Getter for the current temperature target in cooling mode in celcius mode
+    /// @brief Getter for the current temperature target in cooling mode, whatever the display mode is
     /// @return The current temperature target in celcius
     float SetCoolTempC() const;
 
+    /// @brief Getter for the current temperature target in heat mode
+    /// @return The current temperature target in tenths of a degree celcius
+    int16_t SetHeatTenthsC() const;
+
+    /// @brief Getter for the current temperature target in cooling mode
+    /// @return The current temperature target in tenths of a degree celcius
+    int16_t SetCoolTenthsC() const;
+
+    /// @brief Getter for the number of button presses and releases seen, compare with an earlier value to notice input
+    /// @return The edge count, this wraps
+    uint16_t InputEdgeCount() const;
+
     /// @brief Getter for the current temperature mode
     /// @return Farenheit or celcius
     ThermostatTemperatureMode CurrentTempMode();
@@ -94,8 +164,13 @@ class SettingsController {
     ThermostatHvacMode CurrentHeatMode();
 
     /// @brief Accessor for a string representation of the current heat mode
-    /// @return The string value of the heat mode
-    const char* GetHeatModeString();
+    /// @return The string value of the heat mode, this lives in flash so print it directly
+    const __FlashStringHelper* GetHeatModeString();
+
+    /// @brief Get the display string of a heat mode
+    /// @param heatMode The heat mode
+    /// @return The flash string of the heat mode
+    static const __FlashStringHelper* HeatModeString(ThermostatHvacMode heatMode);
 
     /**
      * Pass in the actual debouncers to be used instead of default bounce delays
@@ -104,9 +179,23 @@ class SettingsController {
      * @param upButtonController The controller for the up button
      * @param downButtonController The controller for the down button
      * @param modeButtonController The controller for the mode button
+     * @param tempModeButtonController The controller for the celcius/farenheit button
+     */
+    SettingsController(StableDebouncer incrementBouncer, StableDebouncer decrementBouncer, UpButtonPin upButtonController,
+                       DownButtonPin downButtonController, HeatModeButtonPin modeButtonController,
+                       TempModeButtonPin tempModeButtonController);
+
+    /**
+     * Set the press-and-hold acceleration curve of the up button
+     * @param acceleration The curve to follow while the button is held
+     */
+    void SetIncrementAcceleration(HoldAcceleration acceleration);
+
+    /**
+     * Set the press-and-hold acceleration curve of the down button
+     * @param acceleration The curve to follow while the button is held
      */
-    SettingsController(StableDebouncer incrementBouncer, StableDebouncer decrementBouncer, PinController upButtonController,
-                       PinController downButtonController, PinController modeButtonController);
+    void SetDecrementAcceleration(HoldAcceleration acceleration);
 
     /**
      * Initialize the settings of any internal states
@@ -122,6 +211,34 @@ class SettingsController {
     /// @brief Toggle between heat modes: Off -> Heat -> Cool -> Off
     void ToggleHeatMode();
 
+    /// @brief Toggle between temperature modes: C -> F -> C
+    void ToggleTempMode();
+
+    /// @brief Set the heating target directly, clamped to the setpoint range
+    /// @param setTenthsC The new target in tenths of a degree celcius
+    void ChangeHeatTenthsC(int16_t setTenthsC);
+
+    /// @brief Set the cooling target directly, clamped to the setpoint range
+    /// @param setTenthsC The new target in tenths of a degree celcius
+    void ChangeCoolTenthsC(int16_t setTenthsC);
+
+    /// @brief Set the HVAC mode directly
+    /// @param heatMode Off, Heat, or Cool
+    void ChangeHeatMode(ThermostatHvacMode heatMode);
+
+    /// @brief Set the temperature display mode directly
+    /// @param tempMode Celcius or farenheit
+    void ChangeTempMode(ThermostatTemperatureMode tempMode);
+
+    /// @brief Apply a console setting change with the matching Change method
+    /// @param command The change
+    void ApplyCommand(const SettingCommand & command);
+
+    /// @brief Lock or unlock the buttons, a press while locked still counts as input but changes nothing, and stays
+    /// ignored until every button is released so the press that wakes a blanked display is not acted on
+    /// @param isLocked True to lock
+    void SetInputLocked(bool isLocked);
+
     /// @brief Method to call to execute looping behavior
     void LoopHandler();
 };
@@ -6,7 +6,16 @@
 #ifndef THERMOSTATIO_STABLEDEBOUNCER_H
 #define THERMOSTATIO_STABLEDEBOUNCER_H
 
-enum StableDebouncerState {
+#ifdef THERMOSTAT_MEMORY_LEAN
+/// Configured debounce durations, 16 bits covers up to 65 seconds which is plenty for every debouncer in the lean build,
+/// ThermostatConfig.h checks the configured durations fit at compile time
+typedef uint16_t DebounceDurationMs;
+#else
+/// Configured debounce durations
+typedef unsigned long DebounceDurationMs;
+#endif
+
+enum StableDebouncerState : uint8_t {
   Idle = 0,  // the debouncer has not been used, or does not have a reset cooldown
   StartDelay = 1,  // the debouncer is waiting for calls to execute to stabilize before allowing execution
   Executing = 2,  // allowing execution at most once every X milliseconds
@@ -25,6 +34,9 @@ class StableDebouncer {
 public:
   static constexpr unsigned long DefaultFrequencyMilliseconds = 1000;  // 1 second
 
+  /// The longest duration a debouncer can be configured with
+  static constexpr unsigned long MaxDurationMs = (DebounceDurationMs)~(DebounceDurationMs)0;
+
   /**
    * Constructor for full default configuration
    */
@@ -36,6 +48,13 @@ public:
    */
   explicit StableDebouncer(unsigned long executeFrequencyMs);
 
+  /**
+   * Change the number of milliseconds between debounced executions, this can be called mid-bounce to speed up or
+   * slow down repeats without restarting the flow
+   * @param executeFrequencyMs The number milliseconds to wait between debounced executions
+   */
+  void SetExecuteFrequency(unsigned long executeFrequencyMs);
+
   /**
    * Set the start debounce delay, this will prevent the debounced function from being called for
    * \p startBounceDelayMs with consistent calls to \a Execute.
@@ -64,6 +83,13 @@ public:
    */
   void SetStickyBounce(bool stickyBounce);
 
+  /**
+   * Let the very first execution run without waiting out the execute frequency from boot, every execution after it
+   * is spaced as usual
+   * @param isImmediate If true, the first call to \a Execute that would run does so right away
+   */
+  void SetImmediateFirstExecution(bool isImmediate);
+
   /**
    * Pass this method the function that you would like to run, if you need to run a method, wrap it in a lambda.
    * This is defined here due to type parameter shenanigans
@@ -94,6 +120,12 @@ private:
   /// State flag to indicate that the debouncer is in sticky mode, and will only execute the debounced function once per reset
   bool _isStickyBounce = false;
 
+  /// State flag to let the first execution skip the execute frequency
+  bool _isFirstExecutionImmediate = false;
+
+  /// State flag set once the debounced function has run
+  bool _hasExecuted = false;
+
   /// The time at which the last debounce activity started
   unsigned long _debounceStartExecuteRequestMs = 0;
 
@@ -107,16 +139,20 @@ private:
   unsigned long _lastResetMs = 0;
 
   /// The length of time to wait before allowing repeat of function invocations if no reset has finished executing
-  unsigned long _executeFrequencyMs = DefaultFrequencyMilliseconds;
+  DebounceDurationMs _executeFrequencyMs = DefaultFrequencyMilliseconds;
 
   /// The length of time to wait at the start of a debounce cycle to execute the debounced function
-  unsigned long _debounceStartExecuteDelayMs = 0;
+  DebounceDurationMs _debounceStartExecuteDelayMs = 0;
 
   /// The length of time to wait for consistent calls to reset to fully reset and start cooldown or switch to Idle
-  unsigned long _debounceStopExecuteDelayMs = 0;
+  DebounceDurationMs _debounceStopExecuteDelayMs = 0;
 
   /// The length of time after the debouncer is reset after having executed something to start any new debouncing activity
-  unsigned long _debounceResetCooldownMs = 0;
+  DebounceDurationMs _debounceResetCooldownMs = 0;
+
+  /// Store a requested duration in the configured field width, durations past \a MaxDurationMs are a configuration
+  /// error caught by the checks in ThermostatConfig.h
+  static DebounceDurationMs _toDuration(unsigned long durationMs) { return (DebounceDurationMs)durationMs; }
 
   /// is the amount of time that has passed since the start of the current debounce request greater than the delay?
   bool _isPastStartDelay() const { return (millis() - _debounceStartExecuteRequestMs) >= _debounceStartExecuteDelayMs; }
@@ -203,6 +239,7 @@ private:
         (_state != Executing && _state != StopDelay)  // we are not in an execution mode
         || (_state == StopDelay && _isStickyBounce))  // or the inferred previous state was Executed
       return false;
+    if (_isFirstExecutionImmediate && !_hasExecuted) return true;  // nothing to space the first execution from
     if ((millis() - _lastExecutionMs) < _executeFrequencyMs) return false;  // our last execution was within the bounce timeout
     return true;  // otherwise go for it!
   }
@@ -213,6 +250,7 @@ private:
    */
   void _setExecuted() {
     _lastExecutionMs = millis();
+    _hasExecuted = true;
   }
 
   /**
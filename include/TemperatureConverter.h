@@ -0,0 +1,60 @@
+#include <Arduino.h>
+#include "ThermostatModes.h"
+
+#ifndef TEMPERATURE_CONVERTER_H
+#define TEMPERATURE_CONVERTER_H
+
+/// @brief Celcius/Farenheit conversion backed by precomputed tables.  Temperatures are carried around as
+/// integer tenths of a degree so that display and serial output never need float multiplies or divides.
+class TemperatureConverter {
+  public:
+    /// @brief The lowest temperature covered by the conversion table in tenths of a degree celcius
+    static constexpr int16_t MinTenthsC = -400;
+
+    /// @brief The highest temperature covered by the conversion table in tenths of a degree celcius
+    static constexpr int16_t MaxTenthsC = 600;
+
+    /// @brief The lowest whole farenheit value that a setpoint can be stepped to
+    static constexpr int8_t SetpointMinF = 40;
+
+    /// @brief The highest whole farenheit value that a setpoint can be stepped to
+    static constexpr int8_t SetpointMaxF = 95;
+
+    /// @brief Round a celcius value to tenths, call this once per sample rather than per frame
+    /// @param tempC The temperature in celcius
+    /// @return The temperature in tenths of a degree celcius
+    static int16_t ToTenthsC(float tempC);
+
+    /// @brief Table conversion from tenths celcius to tenths farenheit, clamped to the table range
+    /// @param tenthsC The temperature in tenths of a degree celcius
+    /// @return The temperature in tenths of a degree farenheit
+    static int16_t TenthsCToTenthsF(int16_t tenthsC);
+
+    /// @brief Convert a canonical tenths celcius value to tenths in the given display mode
+    /// @param tenthsC The temperature in tenths of a degree celcius
+    /// @param mode The temperature mode to display in
+    /// @return The temperature in tenths of a degree in \p mode
+    static int16_t ToDisplayTenths(int16_t tenthsC, ThermostatTemperatureMode mode);
+
+    /// @brief Table lookup of the canonical celcius value for a whole farenheit setpoint
+    /// @param tempF The whole farenheit setpoint, clamped to the setpoint range
+    /// @return The setpoint in tenths of a degree celcius
+    static int16_t WholeFToTenthsC(int16_t tempF);
+
+    /// @brief Find the whole farenheit setpoint closest to a celcius value
+    /// @param tenthsC The temperature in tenths of a degree celcius
+    /// @return The nearest whole farenheit setpoint, clamped to the setpoint range
+    static int8_t NearestWholeF(int16_t tenthsC);
+
+    /// @brief Print a tenths value as a decimal with one place
+    /// @param out Where to print to
+    /// @param tenths The value in tenths
+    static void PrintTenths(Print & out, int16_t tenths);
+
+    /// @brief The unit letter of a temperature mode
+    /// @param mode The temperature mode
+    /// @return 'C' or 'F'
+    static char UnitSymbol(ThermostatTemperatureMode mode);
+};
+
+#endif
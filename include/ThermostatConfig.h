@@ -0,0 +1,139 @@
+#include <Arduino.h>
+
+#include "HoldAcceleration.h"
+#include "SerialOutputBuffer.h"
+#include "SHT31Periodic.h"
+#include "BoardPins.h"
+
+#ifndef THERMOSTAT_CONFIG_H
+#define THERMOSTAT_CONFIG_H
+
+/* **************************
+ * Settings
+ */
+
+// the pin map of each board is in BoardPins.h
+
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define OLED_RESET -1
+#define SCREEN_ADDRESS 0x3c
+
+/// The increment of an up/down button press in celcius mode
+const float tempIncrementC = 0.5;
+
+/// The default temperature setting for heating in celcius mode
+const float defaultHeatTempC = 21.0;
+
+/// the default temperature setting for cooling in celcius mode
+const float defaultCoolTempC = 21.0;
+
+/// the amount to over cool or over heat in celcius mode, helps to prevent too many on/off events.  With an adaptive band
+/// this is where the band starts.
+const float hvacOnBufferC = 0.5;
+
+/// Whether the band widens while the running system cycles more often than hvacTargetCyclesPerHour and narrows while
+/// it cycles less often, within hvacBandMinC and hvacBandMaxC and never below a few times the sensor noise
+const bool adaptiveBand = true;
+const float hvacBandMinC = 0.2;
+const float hvacBandMaxC = 1.5;
+const uint8_t hvacTargetCyclesPerHour = 3;
+
+/// Whether the heating and cooling system start and stop ahead of the band edges by the drift learned from past cycles
+const bool predictiveStartStop = true;
+
+/// Whether cooling mode should also run the cooling system inside the temperature band to dehumidify
+const bool dehumidifyOnCool = false;
+
+/// The dew point in celcius at or above which cooling mode will dehumidify
+const float dehumidifyMaxDewPointC = 16.0;
+
+/// How far in celcius the dew point has to fall below dehumidifyMaxDewPointC before cooling stops dehumidifying
+const float dehumidifyDewPointMarginC = 1.0;
+
+/// The least time in milliseconds the cooling system stays off before it restarts, protects the compressor
+const unsigned long coolMinOffMs = 300000;  // 5 minutes
+
+/// The time in milliseconds to wait between HVAC relay state changes, do not set this too low, or you could damage the equipment
+const unsigned long hvacChangeDebounceMs = 5000;  // 5 seconds
+
+/// The time in milliseconds to wait between writing status information to the serial console
+const unsigned long writeDebounceMs = 1000;  // 1 second
+
+/// The time in milliseconds to execute the button action on a continuous press when there is no acceleration curve
+const unsigned long buttonDebounceMs = 1000;  // 1 second
+
+/// Press-and-hold acceleration for the up/down buttons: a slow first repeat so single presses stay precise, then
+/// faster and bigger steps.  This covers the whole setpoint range in about two seconds of holding.
+const HoldAccelerationStage buttonHoldCurve[] = {
+  { 0, 400, 1 },     // first .7 seconds: a step every 400ms
+  { 700, 120, 1 },   // then a step every 120ms
+  { 1100, 80, 5 },   // after 1.1 seconds: five steps every 80ms
+};
+
+/// The time in milliseconds without a button press or release before the display is switched off and stops drawing,
+/// 0 to keep it on
+const unsigned long displayIdleTimeoutMs = 120000;  // 2 minutes
+
+/// The time in milliseconds between reads of the temperature sensor
+const unsigned long sensorReadBounceMs = 500;  // .5 seconds
+
+/// Read the sensor with periodic acquisition, each read is then a short fetch with no conversion wait, falling back to a
+/// single-shot read when a fetch fails.  The rate must be at least one measurement per sensorReadBounceMs.
+const bool sensorPeriodicMode = true;
+const SHT31Repeatability sensorPeriodicRepeatability = SHT31RepeatabilityHigh;
+const SHT31Rate sensorPeriodicRate = SHT31Rate4;
+
+/// The time in milliseconds after the last good sensor read at which the HVAC fails safe to off
+const unsigned long sensorStaleAfterMs = 5000;  // 5 seconds
+
+/// The number of failed sensor reads in a row before the bus is recovered and the sensor is re-initialized
+const uint8_t sensorRecoverAfterErrors = 3;
+
+/// The least time in milliseconds between saves of the HVAC runtime counters, only used when built with
+/// THERMOSTAT_PERSIST_RUNTIME (AVR and ESP32), an EEPROM cell lasts about 100000 writes
+const unsigned long runtimePersistIntervalMs = 3600000;  // 1 hour
+
+/// The time in milliseconds between history samples, whole seconds, the history keeps about 110 samples per block so
+/// at 1 minute the RAM ring (16 blocks) covers a day and the ESP32 flash ring (64 blocks) several days.  Not kept in
+/// the THERMOSTAT_MEMORY_LEAN build.
+const unsigned long historyIntervalMs = 60000;  // 1 minute
+
+/// The I2C bus clock, Fast-mode, both the SHT31 and the SSD1306 support it
+const uint32_t i2cClockHz = 400000;
+
+/// The upper bound in milliseconds on any single I2C transaction, where the core supports a timeout (AVR and ESP32)
+const uint16_t i2cTimeoutMs = 25;
+
+/// The most serial console input bytes consumed per loop, keeps command parsing from stalling the control loop
+const uint8_t consoleBytesPerLoop = 8;
+
+/// What to throw away when serial output is produced faster than the port can send it
+const SerialOverflowPolicy serialOverflowPolicy = DropOldest;
+
+#ifdef THERMOSTAT_RTOS_TASKS
+/// The fixed period in milliseconds of the control task (settings, sensor, HVAC)
+const uint32_t controlPeriodMs = 10;
+
+/// The FreeRTOS priority of the control task, above the UI task so UI load never delays a control step
+const UBaseType_t controlTaskPriority = 3;
+
+/// The FreeRTOS priority of the UI task (display and serial)
+const UBaseType_t uiTaskPriority = 1;
+
+/// The stack sizes in bytes of the tasks
+const uint32_t controlTaskStackBytes = 4096;
+const uint32_t uiTaskStackBytes = 4096;
+#endif
+
+/* *************************************
+ * End settings
+ */
+
+// every duration a debouncer is built with has to fit its duration field, 16 bits in the lean build
+static_assert(hvacChangeDebounceMs <= StableDebouncer::MaxDurationMs, "hvacChangeDebounceMs is too long for a debouncer");
+static_assert(writeDebounceMs <= StableDebouncer::MaxDurationMs, "writeDebounceMs is too long for a debouncer");
+static_assert(buttonDebounceMs <= StableDebouncer::MaxDurationMs, "buttonDebounceMs is too long for a debouncer");
+static_assert(sensorReadBounceMs <= StableDebouncer::MaxDurationMs, "sensorReadBounceMs is too long for a debouncer");
+
+#endif
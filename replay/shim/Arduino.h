@@ -0,0 +1,119 @@
+// Minimal host stand-in for the Arduino core, just enough of the API for the control path to build and run under
+// the replay harness.  Time and pin levels are driven by the harness through ReplayShim.h.
+#ifndef REPLAY_SHIM_ARDUINO_H
+#define REPLAY_SHIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+
+#define SDA 2
+#define SCL 3
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_float(address) (*(const float *)(address))
+#define pgm_read_ptr(address) (*(void * const *)(address))
+#define memcpy_P memcpy
+#define strcmp_P strcmp
+#define strlen_P strlen
+
+class __FlashStringHelper;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+long random(long max);
+long random(long min, long max);
+
+class Print {
+  public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t value) = 0;
+
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+      size_t written = 0;
+      while (size--) written += write(*buffer++);
+      return written;
+    }
+
+    size_t write(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+
+    virtual int availableForWrite() { return 0; }
+
+    size_t print(const __FlashStringHelper *text) { return write(reinterpret_cast<const char *>(text)); }
+    size_t print(const char *text) { return write(text); }
+    size_t print(char value) { return write((uint8_t)value); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC) {
+      char text[24];
+      snprintf(text, sizeof(text), base == HEX ? "%lX" : "%ld", value);
+      return write(text);
+    }
+    size_t print(unsigned long value, int base = DEC) {
+      char text[24];
+      snprintf(text, sizeof(text), base == HEX ? "%lX" : "%lu", value);
+      return write(text);
+    }
+    size_t print(double value, int digits = 2) {
+      char text[32];
+      snprintf(text, sizeof(text), "%.*f", digits, value);
+      return write(text);
+    }
+
+    size_t println() { return write("\r\n"); }
+
+    template<typename T>
+    size_t println(T value) { return print(value) + println(); }
+
+    template<typename T>
+    size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/// The host serial port writes to stdout and never has input
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long) { }
+    size_t write(uint8_t value) override { return fputc(value, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+    int availableForWrite() override { return 64; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,33 @@
+// The control side of the thermostat set up the way main.cpp does it, shared by the replay harness and the host tests
+#ifndef HOST_THERMOSTAT_H
+#define HOST_THERMOSTAT_H
+
+#include "SettingsController.h"
+#include "SensorController.h"
+#include "HvacController.h"
+#include "ThermostatConfig.h"
+
+/// The optional control features, each defaults to its flag in ThermostatConfig.h so a run that changes one says so
+struct HostFeatures {
+  bool isDehumidifyOnCool = dehumidifyOnCool;
+  bool isPredictiveStartStop = predictiveStartStop;
+  bool isAdaptiveBand = adaptiveBand;
+};
+
+/// The settings, sensor and HVAC controllers built and set up like main.cpp's setup().  The sensor has no bus arbiter
+/// and runtime persistence is off, both need the board.
+struct HostThermostat {
+  HostThermostat();
+
+  /// Set the controllers up, call this after the clock is set to the start of the run
+  void Setup(const HostFeatures & features = HostFeatures());
+
+  /// Run the controllers once, as the control step of main.cpp does
+  void Step();
+
+  SettingsController settingsController;
+  SensorController sensorController;
+  HvacController hvacController;
+};
+
+#endif
@@ -0,0 +1,22 @@
+// Controls for the host Arduino stand-in, used by the replay harness to drive time and inputs
+#ifndef REPLAY_SHIM_H
+#define REPLAY_SHIM_H
+
+#include "Arduino.h"
+
+/// Set the time returned by millis() and micros()
+void ReplaySetMillis(unsigned long ms);
+
+/// Set the level digitalRead() returns for a pin
+void ReplaySetPinLevel(uint8_t pin, uint8_t level);
+
+/// The last level written to a pin with digitalWrite()
+uint8_t ReplayPinLevel(uint8_t pin);
+
+/// Set the reading every SHT31 returns from its next read(), this also ends a run of failed reads
+void ReplaySetSensorReading(float tempC, float humidityRel);
+
+/// Make every SHT31 read() fail until the next reading is set
+void ReplaySetSensorFailing();
+
+#endif
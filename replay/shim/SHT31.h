@@ -0,0 +1,34 @@
+// Host stand-in for robtillaart/SHT31, readings come from the trace being replayed
+#ifndef REPLAY_SHIM_SHT31_H
+#define REPLAY_SHIM_SHT31_H
+
+#include "Wire.h"
+
+#define SHT31_LIB_VERSION "replay"
+#define SHT_DEFAULT_ADDRESS 0x44
+
+class SHT31 {
+  public:
+    SHT31(uint8_t address = SHT_DEFAULT_ADDRESS, TwoWire *wire = &Wire) : _address(address), _wire(wire) { }
+
+    bool begin() { return true; }
+    bool isConnected() { return true; }
+    bool read(bool fast = true);
+    bool readData(bool fast = true);
+    uint16_t readStatus() { return 0; }
+    bool reset(bool hard = false) { return true; }
+    float getTemperature() { return _temperature; }
+    float getHumidity() { return _humidity; }
+    int getError() { return 0; }
+
+  protected:
+    // the replayed sensor accepts every command, periodic fetches read the trace like single-shot reads
+    bool writeCmd(uint16_t cmd) { return true; }
+
+    uint8_t _address;
+    TwoWire *_wire;
+    float _temperature = 0;
+    float _humidity = 0;
+};
+
+#endif
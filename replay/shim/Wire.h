@@ -0,0 +1,25 @@
+// Host stand-in for the Arduino Wire library, the replay harness never talks to real devices
+#ifndef REPLAY_SHIM_WIRE_H
+#define REPLAY_SHIM_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire : public Stream {
+  public:
+    void begin() { }
+    void begin(int, int, uint32_t) { }
+    void end() { }
+    void setClock(uint32_t) { }
+    void beginTransmission(uint8_t) { }
+    uint8_t endTransmission(bool = true) { return 0; }
+    uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,79 @@
+# Per-module RAM/flash footprint report for the linked firmware.
+#
+#   pio run -e micro -t footprint
+#
+# Symbols are grouped by the class they belong to (or by their own name for globals such as the
+# controller instances), and split into flash (text + rodata/PROGMEM) and RAM (data + bss).
+
+Import("env")
+
+import re
+import subprocess
+from collections import defaultdict
+
+# nm section letters, lower case is local and upper case is global
+FLASH_TYPES = set("tTrR")
+RAM_TYPES = set("dDbBvV")
+
+
+def _module_of(symbol):
+    symbol = re.sub(r"^(vtable|typeinfo|typeinfo name|guard variable|construction vtable) for ", "", symbol)
+    symbol = symbol.split("(")[0]
+
+    # strip template arguments so every instantiation lands on its class
+    depth = 0
+    stripped = ""
+    for character in symbol:
+        if character == "<":
+            depth += 1
+        elif character == ">":
+            depth -= 1
+        elif depth == 0:
+            stripped += character
+
+    parts = [part for part in stripped.split("::") if part]
+    if len(parts) > 1:
+        return parts[-2]
+    return parts[0] if parts else symbol
+
+
+def footprint(target, source, env):
+    elf = env.subst("$BUILD_DIR/${PROGNAME}.elf")
+    # the toolchains only expose the compiler, nm sits next to it with the same prefix
+    compiler = env.subst("$CC")
+    nm = compiler[:-3] + "nm" if compiler.endswith("gcc") else "nm"
+
+    output = subprocess.check_output([nm, "--print-size", "--size-sort", "-C", elf]).decode()
+
+    flash = defaultdict(int)
+    ram = defaultdict(int)
+    for line in output.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) < 4:
+            continue
+
+        size = int(fields[1], 16)
+        kind = fields[2]
+        module = _module_of(fields[3])
+
+        if kind in FLASH_TYPES:
+            flash[module] += size
+        elif kind in RAM_TYPES:
+            ram[module] += size
+
+    modules = sorted(set(flash) | set(ram), key=lambda name: (ram[name], flash[name]), reverse=True)
+
+    print("%-32s %8s %8s" % ("module", "ram", "flash"))
+    for module in modules:
+        print("%-32s %8d %8d" % (module[:32], ram[module], flash[module]))
+    print("%-32s %8d %8d" % ("total", sum(ram.values()), sum(flash.values())))
+    print("note: the SSD1306 framebuffer is heap allocated by display.begin() and is not listed")
+
+
+env.AddCustomTarget(
+    name="footprint",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=footprint,
+    title="Footprint",
+    description="Per-module RAM and flash usage of the firmware",
+)
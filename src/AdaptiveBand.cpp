@@ -0,0 +1,42 @@
+#include "AdaptiveBand.h"
+
+AdaptiveBand::AdaptiveBand(int16_t bandCentiC) : _bandCentiC(bandCentiC) { }
+
+void AdaptiveBand::Enable(int16_t minCentiC, int16_t maxCentiC, uint8_t targetCyclesPerHour) {
+  _minCentiC = minCentiC;
+  _maxCentiC = maxCentiC;
+  _targetCyclesPerHour = targetCyclesPerHour;
+  _lastAdjustMs = millis();
+}
+
+void AdaptiveBand::Update(int16_t tempCentiC, uint16_t cyclesPerHour, unsigned long nowMs) {
+  if (_targetCyclesPerHour == 0) return;
+
+  if (_hasReading) {
+    int16_t difference = tempCentiC - _lastTempCentiC;
+    uint16_t sample = (uint16_t)(difference < 0 ? -difference : difference) * 16;
+
+    // a sixteenth of the way to each new difference, about the last minute and a half of decisions
+    _noiseScaled += ((int32_t)sample - _noiseScaled) / 16;
+  }
+  _lastTempCentiC = tempCentiC;
+  _hasReading = true;
+
+  if (nowMs - _lastAdjustMs < AdjustPeriodMs) return;
+  _lastAdjustMs = nowMs;
+
+  if (cyclesPerHour > _targetCyclesPerHour)
+    _bandCentiC += StepCentiC;
+  else if (cyclesPerHour > 0 && cyclesPerHour < _targetCyclesPerHour)
+    _bandCentiC -= StepCentiC;
+
+  int16_t floorCentiC = NoiseCentiC() * NoiseMultiple;
+  if (floorCentiC < _minCentiC) floorCentiC = _minCentiC;
+
+  if (_bandCentiC < floorCentiC) _bandCentiC = floorCentiC;
+  if (_bandCentiC > _maxCentiC) _bandCentiC = _maxCentiC;
+}
+
+int16_t AdaptiveBand::BandCentiC() const { return _bandCentiC; }
+
+int16_t AdaptiveBand::NoiseCentiC() const { return (_noiseScaled + 8) / 16; }
@@ -0,0 +1,74 @@
+#include "ComfortMetrics.h"
+
+/// Saturation vapor pressure in hPa (Magnus, 6.112 * exp(17.62T / (243.12 + T))) from -20C to 60C in 2C steps
+static const float PROGMEM saturationPressureHpa[ComfortMetrics::TableSize] = {
+    1.2597f, 1.4939f, 1.7665f, 2.0826f, 2.4483f, 2.8703f, 3.3559f, 3.9134f, 4.5517f, 5.2809f,
+    6.1120f, 7.0570f, 8.1292f, 9.3430f, 10.7143f, 12.2603f, 13.9998f, 15.9531f, 18.1423f, 20.5913f,
+    23.3260f, 26.3742f, 29.7659f, 33.5334f, 37.7115f, 42.3372f, 47.4505f, 53.0939f, 59.3128f, 66.1558f,
+    73.6746f, 81.9241f, 90.9627f, 100.8523f, 111.6588f, 123.4516f, 136.3042f, 150.2945f, 165.5043f, 182.0201f,
+    199.9329f
+};
+
+/// Saturated water vapor density in g/m^3 (216.7 * es / (T + 273.15)) over the same range as above
+static const float PROGMEM saturationDensityGm3[ComfortMetrics::TableSize] = {
+    1.0783f, 1.2688f, 1.4886f, 1.7415f, 2.0316f, 2.3637f, 2.7427f, 3.1744f, 3.6647f, 4.2205f,
+    4.8489f, 5.5579f, 6.3561f, 7.2528f, 8.2582f, 9.3830f, 10.6391f, 12.0391f, 13.5965f, 15.3259f,
+    17.2428f, 19.3640f, 21.7071f, 24.2911f, 27.1362f, 30.2638f, 33.6966f, 37.4587f, 41.5756f, 46.0741f,
+    50.9829f, 56.3317f, 62.1523f, 68.4778f, 75.3432f, 82.7850f, 90.8415f, 99.5531f, 108.9618f, 119.1114f,
+    130.0479f
+};
+
+float ComfortMetrics::_interpolate(const float *table, float tempC) {
+  float position = (tempC - TableMinTempC) * (1.0f / TableStepC);
+
+  if (position <= 0) return pgm_read_float(&table[0]);
+  if (position >= TableSize - 1) return pgm_read_float(&table[TableSize - 1]);
+
+  uint8_t index = (uint8_t)position;
+  float low = pgm_read_float(&table[index]);
+  float high = pgm_read_float(&table[index + 1]);
+
+  return low + (high - low) * (position - index);
+}
+
+float ComfortMetrics::DewPointC(float tempC, float humidityRel) {
+  // the dew point is the temperature where the saturation pressure equals the actual vapor pressure,
+  // so search the (monotonic) table instead of inverting the Magnus formula with a log
+  float vaporPressure = _interpolate(saturationPressureHpa, tempC) * humidityRel * 0.01f;
+
+  if (vaporPressure <= pgm_read_float(&saturationPressureHpa[0])) return TableMinTempC;
+  if (vaporPressure >= pgm_read_float(&saturationPressureHpa[TableSize - 1]))
+    return TableMinTempC + TableStepC * (TableSize - 1);
+
+  // binary search for the bracketing pair so the cost is a handful of compares
+  uint8_t lowIndex = 0;
+  uint8_t highIndex = TableSize - 1;
+  while (highIndex - lowIndex > 1) {
+    uint8_t middle = (lowIndex + highIndex) / 2;
+
+    if (pgm_read_float(&saturationPressureHpa[middle]) <= vaporPressure) lowIndex = middle;
+    else highIndex = middle;
+  }
+
+  float low = pgm_read_float(&saturationPressureHpa[lowIndex]);
+  float high = pgm_read_float(&saturationPressureHpa[highIndex]);
+
+  return TableMinTempC + TableStepC * (lowIndex + (vaporPressure - low) / (high - low));
+}
+
+float ComfortMetrics::AbsoluteHumidity(float tempC, float humidityRel) {
+  return _interpolate(saturationDensityGm3, tempC) * humidityRel * 0.01f;
+}
+
+float ComfortMetrics::HeatIndexC(float tempC, float humidityRel) {
+  // the regression is only meaningful in warm, humid air
+  if (tempC < 27.0f || humidityRel < 40.0f) return tempC;
+
+  const float t = tempC;
+  const float r = humidityRel;
+
+  // Rothfusz regression with celcius coefficients, in Horner form on the humidity term
+  return (-8.78469475556f + t * (1.61139411f - 0.012308094f * t))
+         + r * ((2.33854883889f + t * (-0.14611605f + 0.002211732f * t))
+         + r * (-0.0164248277778f + t * (0.00072546f - 0.000003582f * t)));
+}
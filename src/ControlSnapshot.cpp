@@ -0,0 +1,24 @@
+#include "ControlSnapshot.h"
+
+void ControlSnapshotBuffer::Publish(const ControlSnapshot & snapshot) {
+  _sequence = _sequence + 1;
+  __sync_synchronize();
+
+  _snapshot = snapshot;
+
+  __sync_synchronize();
+  _sequence = _sequence + 1;
+}
+
+void ControlSnapshotBuffer::Read(ControlSnapshot & snapshot) const {
+  uint32_t sequence;
+
+  do {
+    sequence = _sequence;
+    __sync_synchronize();
+
+    snapshot = _snapshot;
+
+    __sync_synchronize();
+  } while((sequence & 1) || sequence != _sequence);
+}
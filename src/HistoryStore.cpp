@@ -0,0 +1,350 @@
+#include "HistoryStore.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <LittleFS.h>
+
+/// the block ring, MaxBlocks blocks at sequence number modulo MaxBlocks
+static const char historyPath[] = "/history.bin";
+#endif
+
+// header field offsets
+static const uint8_t historyMagicOffset = 0;
+static const uint8_t historySeqOffset = 1;
+static const uint8_t historyBootOffset = 5;
+static const uint8_t historyStartOffset = 7;
+static const uint8_t historyIntervalOffset = 11;
+static const uint8_t historyTempOffset = 13;
+static const uint8_t historyHumidityOffset = 15;
+static const uint8_t historyRelaysOffset = 17;
+static const uint8_t historyLengthOffset = 18;
+
+static void putLe(uint8_t *data, uint32_t value, uint8_t size) {
+  uint8_t i;
+  for (i = 0; i < size; i++) {
+    data[i] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+static uint32_t getLe(const uint8_t *data, uint8_t size) {
+  uint32_t value = 0;
+  while (size > 0) {
+    size--;
+    value = (value << 8) | data[size];
+  }
+  return value;
+}
+
+static uint32_t zigzag(int32_t value) { return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); }
+
+static int32_t unzigzag(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+/// read a varint ending before end, false if it runs past
+static bool readVarint(const uint8_t *data, uint16_t & offset, uint16_t end, uint32_t & value) {
+  uint8_t shift = 0;
+  value = 0;
+  while (offset < end && shift < 32) {
+    uint8_t group = data[offset++];
+    value |= (uint32_t)(group & 0x7f) << shift;
+    if (!(group & 0x80)) return true;
+    shift += 7;
+  }
+  return false;
+}
+
+HistoryStore::HistoryStore(unsigned long intervalMs) : _intervalMs(intervalMs) { }
+
+bool HistoryStore::Begin() {
+  if (_isBegun) return true;
+
+  uint32_t newestSeq = 0;
+  uint16_t newestBoot = 0;
+  bool hasBlock = false;
+
+#ifdef ARDUINO_ARCH_ESP32
+  if (!LittleFS.begin(true)) return false;
+
+  if (!LittleFS.exists(historyPath)) {
+    // claim the whole ring up front, so running out of flash shows up now rather than hours in
+    File file = LittleFS.open(historyPath, "w");
+    if (!file) return false;
+
+    uint8_t empty[BlockBytes];
+    memset(empty, 0, sizeof(empty));
+
+    uint16_t slot;
+    for (slot = 0; slot < MaxBlocks; slot++)
+      file.write(empty, sizeof(empty));
+    file.close();
+  }
+
+  File file = LittleFS.open(historyPath, "r");
+  if (!file) return false;
+
+  uint8_t header[_headerBytes];
+  uint16_t slot;
+  for (slot = 0; slot < MaxBlocks; slot++) {
+    if (!file.seek((uint32_t)slot * BlockBytes) || file.read(header, sizeof(header)) != sizeof(header)) break;
+    if (header[historyMagicOffset] != _magic) continue;
+
+    uint32_t seq = getLe(&header[historySeqOffset], 4);
+    if (seq % MaxBlocks != slot) continue;
+
+    _storedBlocks++;
+    if (!hasBlock || seq > newestSeq) {
+      newestSeq = seq;
+      newestBoot = getLe(&header[historyBootOffset], 2);
+      hasBlock = true;
+    }
+  }
+  file.close();
+#endif
+
+  if (hasBlock) {
+    _boot = newestBoot + 1;
+    _nextSeq = newestSeq + 1;
+    _storedEndSeq = newestSeq + 1;
+  }
+
+  __sync_synchronize();
+  _isBegun = true;
+  return true;
+}
+
+bool HistoryStore::IsBegun() const { return _isBegun; }
+
+void HistoryStore::Record(int16_t tempTenthsC, uint16_t humidityTenthsRel, bool isReadingValid, uint8_t relays) {
+  if (!_isBegun) return;
+
+  unsigned long nowMs = millis();
+
+  if (_isCloseRequested && !_isPendingFull) {
+    if (_openLength > 0) _completeBlock();
+    _isCloseRequested = false;
+  }
+
+  if (!isReadingValid) {
+    // the time of the next sample is only known from a new block header
+    if (_openLength > 0) _completeBlock();
+    _hasSample = false;
+  } else if (!_hasSample || nowMs - _lastSampleMs >= _intervalMs) {
+    _sample(tempTenthsC, humidityTenthsRel, relays, nowMs);
+  }
+
+  if (relays == _lastRelays) return;
+  _lastRelays = relays;
+
+  if (_openLength == 0) return;
+
+  if (BlockBytes - _openLength < _reserveBytes) {
+    // still seen in the relays of the next block header
+    _controlLostRecords++;
+    return;
+  }
+
+  uint32_t seconds = (nowMs - _lastSampleMs) / 1000;
+  _appendVarint((((seconds << 3) | (relays & 0x07)) << 1) | 1);
+}
+
+void HistoryStore::LoopHandler() {
+  if (_isPendingFull) {
+    __sync_synchronize();
+    _storeBlock(_pending);
+    __sync_synchronize();
+    _isPendingFull = false;
+  }
+
+  if (!_exportOutput || _exportOutput->availableForWrite() < _exportLineBytes) return;
+
+  if (_isExportWaiting) {
+    if (_isCloseRequested || _isPendingFull) return;
+
+    _isExportWaiting = false;
+    _exportSeq = _storedEndSeq - _storedBlocks;
+    _exportOffset = 0;
+    _exportOutput->println(F("hist begin"));
+    return;
+  }
+
+  _exportNext();
+}
+
+bool HistoryStore::StartExport(Print & output) {
+  // the close request is only ever served by Record, which does nothing before the storage is mounted
+  if (_exportOutput || !_isBegun) return false;
+
+  _exportOutput = &output;
+  _isExportWaiting = true;
+  _isCloseRequested = true;
+
+  return true;
+}
+
+bool HistoryStore::IsExporting() const { return _exportOutput != nullptr; }
+
+uint16_t HistoryStore::StoredBlocks() const { return _storedBlocks; }
+
+unsigned long HistoryStore::LostRecords() const { return _controlLostRecords + _storeLostRecords; }
+
+void HistoryStore::_sample(int16_t tempTenthsC, uint16_t humidityTenthsRel, uint8_t relays, unsigned long nowMs) {
+  if (_openLength > 0 && BlockBytes - _openLength < _maxSampleBytes) _completeBlock();
+
+  if (!_hasSample) {
+    _lastSampleMs = nowMs;
+    _lastSampleSeconds = nowMs / 1000;
+    _hasSample = true;
+  } else {
+    // stay on the interval grid, the decoder only knows sample times from it
+    _lastSampleMs += _intervalMs;
+    _lastSampleSeconds += _intervalMs / 1000;
+  }
+
+  if (_openLength == 0) {
+    _open[historyMagicOffset] = _magic;
+    putLe(&_open[historySeqOffset], _nextSeq++, 4);
+    putLe(&_open[historyBootOffset], _boot, 2);
+    putLe(&_open[historyStartOffset], _lastSampleSeconds, 4);
+    putLe(&_open[historyIntervalOffset], _intervalMs / 1000, 2);
+    putLe(&_open[historyTempOffset], (uint16_t)tempTenthsC, 2);
+    putLe(&_open[historyHumidityOffset], humidityTenthsRel, 2);
+    _open[historyRelaysOffset] = relays & 0x07;
+    _openLength = _headerBytes;
+    _lastRelays = relays;
+  } else {
+    _appendVarint(zigzag((int32_t)tempTenthsC - _lastTempTenthsC) << 1);
+    _appendVarint(zigzag((int32_t)humidityTenthsRel - _lastHumidityTenthsRel));
+  }
+
+  _lastTempTenthsC = tempTenthsC;
+  _lastHumidityTenthsRel = humidityTenthsRel;
+}
+
+void HistoryStore::_appendVarint(uint32_t value) {
+  do {
+    uint8_t group = value & 0x7f;
+    value >>= 7;
+    _open[_openLength++] = value ? (group | 0x80) : group;
+  } while (value);
+}
+
+void HistoryStore::_completeBlock() {
+  putLe(&_open[historyLengthOffset], _openLength - _headerBytes, 2);
+
+  if (_isPendingFull) {
+    _controlLostRecords++;
+  } else {
+    memcpy(_pending, _open, BlockBytes);
+    __sync_synchronize();
+    _isPendingFull = true;
+  }
+
+  _openLength = 0;
+}
+
+void HistoryStore::_storeBlock(const uint8_t *block) {
+  uint32_t seq = getLe(&block[historySeqOffset], 4);
+
+#ifdef ARDUINO_ARCH_ESP32
+  File file = LittleFS.open(historyPath, "r+");
+  if (!file || !file.seek((seq % MaxBlocks) * BlockBytes) || file.write(block, BlockBytes) != BlockBytes) {
+    _storeLostRecords++;
+    return;
+  }
+  file.close();
+#else
+  memcpy(_blocks[seq % MaxBlocks], block, BlockBytes);
+#endif
+
+  if (_storedBlocks < MaxBlocks) _storedBlocks++;
+  _storedEndSeq = seq + 1;
+}
+
+bool HistoryStore::_loadBlock(uint32_t seq, uint8_t *block) {
+#ifdef ARDUINO_ARCH_ESP32
+  File file = LittleFS.open(historyPath, "r");
+  if (!file || !file.seek((seq % MaxBlocks) * BlockBytes) || file.read(block, BlockBytes) != BlockBytes) return false;
+  file.close();
+#else
+  memcpy(block, _blocks[seq % MaxBlocks], BlockBytes);
+#endif
+
+  return block[historyMagicOffset] == _magic && getLe(&block[historySeqOffset], 4) == seq
+      && getLe(&block[historyLengthOffset], 2) <= BlockBytes - _headerBytes;
+}
+
+void HistoryStore::_exportNext() {
+  Print & out = *_exportOutput;
+
+  if (_exportOffset == 0) {
+    // skip blocks lost before they were stored
+    while (_exportSeq != _storedEndSeq && !_loadBlock(_exportSeq, _exportBlock))
+      _exportSeq++;
+
+    if (_exportSeq == _storedEndSeq) {
+      out.println(F("hist end"));
+      _exportOutput = nullptr;
+      return;
+    }
+
+    _exportSeconds = getLe(&_exportBlock[historyStartOffset], 4);
+    _exportTempTenthsC = (int16_t)getLe(&_exportBlock[historyTempOffset], 2);
+    _exportHumidityTenthsRel = getLe(&_exportBlock[historyHumidityOffset], 2);
+    _exportOffset = _headerBytes;
+
+    out.print(F("b "));
+    out.print(_exportSeq);
+    out.print(' ');
+    out.print(getLe(&_exportBlock[historyBootOffset], 2));
+    out.print(' ');
+    out.print(getLe(&_exportBlock[historyIntervalOffset], 2));
+    out.print(' ');
+    out.print(_exportSeconds);
+    out.print(' ');
+    out.print(_exportTempTenthsC);
+    out.print(' ');
+    out.print(_exportHumidityTenthsRel);
+    out.print(' ');
+    out.println(_exportBlock[historyRelaysOffset]);
+    return;
+  }
+
+  uint16_t end = _headerBytes + getLe(&_exportBlock[historyLengthOffset], 2);
+  uint32_t value;
+
+  if (_exportOffset >= end || !readVarint(_exportBlock, _exportOffset, end, value)) {
+    _exportOffset = 0;
+    _exportSeq++;
+    return;
+  }
+
+  if (value & 1) {
+    out.print(F("r "));
+    out.print(_exportSeconds + (value >> 4));
+    out.print(' ');
+    out.println((value >> 1) & 0x07);
+  } else {
+    uint32_t humidity;
+    if (!readVarint(_exportBlock, _exportOffset, end, humidity)) {
+      _exportOffset = 0;
+      _exportSeq++;
+      return;
+    }
+
+    _exportSeconds += getLe(&_exportBlock[historyIntervalOffset], 2);
+    _exportTempTenthsC += unzigzag(value >> 1);
+    _exportHumidityTenthsRel += unzigzag(humidity);
+
+    out.print(F("s "));
+    out.print(_exportSeconds);
+    out.print(' ');
+    out.print(_exportTempTenthsC);
+    out.print(' ');
+    out.println(_exportHumidityTenthsRel);
+  }
+
+  // an exhausted block moves on at the next pass
+  if (_exportOffset >= end) {
+    _exportOffset = 0;
+    _exportSeq++;
+  }
+}
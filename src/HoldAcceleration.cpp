@@ -0,0 +1,34 @@
+#include "HoldAcceleration.h"
+
+HoldAcceleration::HoldAcceleration() = default;
+
+HoldAcceleration::HoldAcceleration(const HoldAccelerationStage *stages, uint8_t stageCount)
+  : _stages(stages), _stageCount(stageCount) { }
+
+uint8_t HoldAcceleration::Update(StableDebouncer & bouncer) {
+  if (_stageCount == 0) return 1;
+
+  if (!_isHeld) {
+    _isHeld = true;
+    _holdStartMs = millis();
+    _stageIndex = 0;
+    _applyStage(bouncer);
+  }
+
+  // stages only ever move forward during a hold, so this is a single compare on most loops
+  unsigned long heldMs = millis() - _holdStartMs;
+  if (_stageIndex + 1 < _stageCount && heldMs >= _stages[_stageIndex + 1].holdMs) {
+    _stageIndex++;
+    _applyStage(bouncer);
+  }
+
+  return _stages[_stageIndex].stepMultiplier;
+}
+
+void HoldAcceleration::Reset(StableDebouncer & bouncer) {
+  if (!_isHeld) return;
+
+  _isHeld = false;
+  _stageIndex = 0;
+  _applyStage(bouncer);
+}
@@ -1,12 +1,107 @@
 #include "HvacController.h"
+#include "RuntimeStore.h"
 
-HvacController::HvacController(unsigned long hvacChangeDebounceMs, int coolPin, int heatPin, int fanPin)
-  : _hvacChangeDebouncer(StableDebouncer(hvacChangeDebounceMs)) {
-  _pinCool = coolPin;
-  _pinHeat = heatPin;
-  _pinFan = fanPin;
+HvacController::HvacController(unsigned long hvacChangeDebounceMs, float bufferC, CoolRelayPin coolRelay,
+                               HeatRelayPin heatRelay, FanRelayPin fanRelay)
+  : _hvacChangeDebouncer(StableDebouncer(hvacChangeDebounceMs)), _coolRelay(coolRelay), _heatRelay(heatRelay),
+    _fanRelay(fanRelay), _band(AdaptiveBand((int16_t)(bufferC * 100.0f + 0.5f))) {
+  // decide on the first pass after boot, the relays have been off since boot so there is no change to space this from
+  _hvacChangeDebouncer.SetImmediateFirstExecution(true);
 }
 
+void HvacController::Initialize() {
+  _coolRelay.Initialize();
+  _heatRelay.Initialize();
+  _fanRelay.Initialize();
+}
+
+void HvacController::EnableDehumidifyOnCool(float maxDewPointC, float marginC) {
+  _isDehumidifyOnCool = true;
+  _dehumidifyMaxDewPointC = maxDewPointC;
+  _dehumidifyMarginC = marginC;
+}
+
+void HvacController::DisableDehumidifyOnCool() {
+  _isDehumidifyOnCool = false;
+}
+
+void HvacController::SetCoolMinOffTime(unsigned long minOffMs) {
+  _coolMinOffMs = minOffMs;
+}
+
+void HvacController::EnableAdaptiveBand(float minC, float maxC, uint8_t targetCyclesPerHour) {
+  _band.Enable((int16_t)(minC * 100.0f + 0.5f), (int16_t)(maxC * 100.0f + 0.5f), targetCyclesPerHour);
+}
+
+float HvacController::HysteresisBandC() const { return _bufferC(); }
+
+float HvacController::SensorNoiseC() const { return _band.NoiseCentiC() / 100.0; }
+
+void HvacController::EnablePredictiveStartStop() {
+  _isPredictiveStartStop = true;
+}
+
+void HvacController::DisablePredictiveStartStop() {
+  _isPredictiveStartStop = false;
+}
+
+unsigned long HvacController::FirstDecisionMicros() const { return _firstDecisionMicros; }
+
+bool HvacController::IsCoolOn() const { return _isCoolOn; }
+
+bool HvacController::IsHeatOn() const { return _isHeatOn; }
+
+bool HvacController::IsFanOn() const { return _isFanOn; }
+
+const RelayRuntimeStats & HvacController::CoolStats() const { return _coolStats; }
+
+const RelayRuntimeStats & HvacController::HeatStats() const { return _heatStats; }
+
+const RelayRuntimeStats & HvacController::FanStats() const { return _fanStats; }
+
+const RecoveryModel & HvacController::Recovery() const { return _recoveryModel; }
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+void HvacController::EnableRuntimePersistence(unsigned long minIntervalMs) {
+  RelayRuntimeTotals totals[3];
+
+  if(RuntimeStore::Load(totals, 3)) {
+    _coolStats.Restore(totals[0]);
+    _heatStats.Restore(totals[1]);
+    _fanStats.Restore(totals[2]);
+  }
+
+  _isRuntimePersisted = true;
+  _persistIntervalMs = minIntervalMs;
+  _lastPersistMs = millis();
+}
+
+void HvacController::PersistRuntimeIfDue() {
+  if(!_isPersistDue)
+    return;
+  __sync_synchronize();
+
+  RuntimeStore::Save(_persistTotals, 3);
+
+  __sync_synchronize();
+  _isPersistDue = false;
+}
+
+void HvacController::_persistRuntime(unsigned long nowMs) {
+  // the next relay change tries again if the UI side has not saved the last copy yet
+  if(!_isRuntimePersisted || _isPersistDue || nowMs - _lastPersistMs < _persistIntervalMs)
+    return;
+
+  _persistTotals[0] = _coolStats.Totals();
+  _persistTotals[1] = _heatStats.Totals();
+  _persistTotals[2] = _fanStats.Totals();
+  _lastPersistMs = nowMs;
+
+  __sync_synchronize();
+  _isPersistDue = true;
+}
+#endif
+
 void HvacController::LoopHandler(SensorController & sensorController, SettingsController & settingsController) {
   auto wrapper = [this, &sensorController, &settingsController]() { _setHvacStates(sensorController, settingsController); };
   _hvacChangeDebouncer.Execute(wrapper);
@@ -0,0 +1,43 @@
+#include "I2cArbiter.h"
+
+I2cArbiter::I2cArbiter(I2cBus & bus) : _bus(bus) {
+#ifdef THERMOSTAT_RTOS_TASKS
+  _mutex = xSemaphoreCreateMutexStatic(&_mutexBuffer);
+#endif
+}
+
+I2cBus & I2cArbiter::Bus() { return _bus; }
+
+unsigned long I2cArbiter::BusyMicros(I2cClient client) const { return _busyMicros[client]; }
+
+unsigned long I2cArbiter::Transactions(I2cClient client) const { return _transactions[client]; }
+
+uint16_t I2cArbiter::UtilizationPerMille(I2cClient client) const {
+  unsigned long windowMs = millis() - _windowStartMs;
+  if (windowMs == 0) return 0;
+
+  // microseconds busy per millisecond of wall time is already per mille
+  unsigned long perMille = _busyMicros[client] / windowMs;
+  return perMille > 1000 ? 1000 : (uint16_t)perMille;
+}
+
+void I2cArbiter::TakeStats(I2cClientStats (&stats)[I2cClientCount]) {
+#ifdef THERMOSTAT_RTOS_TASKS
+  xSemaphoreTake(_mutex, portMAX_DELAY);
+#endif
+  uint8_t client;
+
+  for (client = 0; client < I2cClientCount; client++) {
+    stats[client].busyMicros = _busyMicros[client];
+    stats[client].transactions = _transactions[client];
+    stats[client].utilizationPerMille = UtilizationPerMille((I2cClient)client);
+
+    _busyMicros[client] = 0;
+    _transactions[client] = 0;
+  }
+
+  _windowStartMs = millis();
+#ifdef THERMOSTAT_RTOS_TASKS
+  xSemaphoreGive(_mutex);
+#endif
+}
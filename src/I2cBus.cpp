@@ -0,0 +1,58 @@
+#include "I2cBus.h"
+
+/// Half of a 100kHz clock period, used while bit-banging the recovery sequence
+static const unsigned int recoveryHalfPeriodUs = 5;
+
+I2cBus::I2cBus(TwoWire & wire, uint8_t sdaPin, uint8_t sclPin, uint32_t clockHz, uint16_t timeoutMs)
+  : _wire(wire), _sdaPin(sdaPin), _sclPin(sclPin), _clockHz(clockHz), _timeoutMs(timeoutMs) { }
+
+void I2cBus::Begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+  _wire.begin(_sdaPin, _sclPin, _clockHz);
+  _wire.setTimeOut(_timeoutMs);
+#else
+  _wire.begin();
+  _wire.setClock(_clockHz);
+#if defined(WIRE_HAS_TIMEOUT)
+  // reset the TWI hardware on timeout so the next transaction starts clean
+  _wire.setWireTimeout((uint32_t)_timeoutMs * 1000, true);
+#endif
+#endif
+}
+
+bool I2cBus::Probe(uint8_t address) {
+  _wire.beginTransmission(address);
+  return _wire.endTransmission() == 0;
+}
+
+void I2cBus::Recover() {
+  _recoveryCount++;
+  _wire.end();
+
+  // the lines are open drain: drive low with OUTPUT/LOW, release with INPUT_PULLUP
+  pinMode(_sdaPin, INPUT_PULLUP);
+  pinMode(_sclPin, INPUT_PULLUP);
+  delayMicroseconds(recoveryHalfPeriodUs);
+
+  uint8_t pulse;
+  for (pulse = 0; pulse < 9 && digitalRead(_sdaPin) == LOW; pulse++) {
+    pinMode(_sclPin, OUTPUT);
+    digitalWrite(_sclPin, LOW);
+    delayMicroseconds(recoveryHalfPeriodUs);
+    pinMode(_sclPin, INPUT_PULLUP);
+    delayMicroseconds(recoveryHalfPeriodUs);
+  }
+
+  // STOP: SDA rises while SCL is high
+  pinMode(_sdaPin, OUTPUT);
+  digitalWrite(_sdaPin, LOW);
+  delayMicroseconds(recoveryHalfPeriodUs);
+  pinMode(_sdaPin, INPUT_PULLUP);
+  delayMicroseconds(recoveryHalfPeriodUs);
+
+  Begin();
+}
+
+TwoWire & I2cBus::Wire() { return _wire; }
+
+unsigned long I2cBus::RecoveryCount() const { return _recoveryCount; }
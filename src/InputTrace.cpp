@@ -0,0 +1,109 @@
+#include "InputTrace.h"
+#include "BoardPins.h"
+
+InputTraceRecorder *InputTraceRecorder::_active = nullptr;
+
+InputTraceRecorder::InputTraceRecorder(Print & output) : _output(output) { }
+
+void InputTraceRecorder::Begin() {
+  const uint8_t header[] = { 'T', 'I', 'O', INPUT_TRACE_VERSION, CurrentBoard };
+
+  _output.write(header, sizeof(header));
+  _lastRecordMs = 0;
+  _active = this;
+}
+
+void InputTraceRecorder::RecordSensor(float tempC, float humidityRel) {
+  if (!_active) return;
+
+  int16_t tempCentiC = (int16_t)(tempC * 100.0f + (tempC < 0 ? -0.5f : 0.5f));
+  uint16_t humidityCentiRel = (uint16_t)(humidityRel * 100.0f + 0.5f);
+
+  if (_active->_hasSensorRecord && tempCentiC == _active->_lastTempCentiC
+      && humidityCentiRel == _active->_lastHumidityCentiRel)
+    return;
+
+  const uint8_t payload[] = {
+      (uint8_t)(tempCentiC & 0xff), (uint8_t)((uint16_t)tempCentiC >> 8),
+      (uint8_t)(humidityCentiRel & 0xff), (uint8_t)(humidityCentiRel >> 8)
+  };
+
+  if (_active->_writeRecord(InputTraceSensor, payload, sizeof(payload))) {
+    _active->_hasSensorRecord = true;
+    _active->_isSensorFailing = false;
+    _active->_lastTempCentiC = tempCentiC;
+    _active->_lastHumidityCentiRel = humidityCentiRel;
+  }
+}
+
+void InputTraceRecorder::RecordSensorError() {
+  if (!_active || _active->_isSensorFailing) return;
+
+  if (_active->_writeRecord(InputTraceSensorError, nullptr, 0)) {
+    // the next good reading is always recorded so replay knows the failure is over
+    _active->_isSensorFailing = true;
+    _active->_hasSensorRecord = false;
+  }
+}
+
+void InputTraceRecorder::RecordPin(uint8_t pin, uint8_t level) {
+  if (!_active) return;
+
+  uint8_t index;
+  for (index = 0; index < _active->_pinCount && _active->_pins[index] != pin; index++) { }
+
+  bool isNew = index == _active->_pinCount;
+  if (isNew && index == MaxPins) return;
+
+  uint8_t mask = 1 << index;
+  bool isHigh = level != LOW;
+  if (!isNew && ((_active->_pinLevels & mask) != 0) == isHigh) return;
+
+  const uint8_t payload[] = { pin, (uint8_t)(isHigh ? HIGH : LOW) };
+
+  if (_active->_writeRecord(InputTracePin, payload, sizeof(payload))) {
+    if (isNew) _active->_pins[_active->_pinCount++] = pin;
+
+    _active->_pinLevels = isHigh ? (_active->_pinLevels | mask) : (_active->_pinLevels & ~mask);
+  }
+}
+
+void InputTraceRecorder::RecordSetting(uint8_t kind, int16_t value) {
+  if (!_active) return;
+
+  const uint8_t payload[] = { kind, (uint8_t)(value & 0xff), (uint8_t)((uint16_t)value >> 8) };
+
+  _active->_writeRecord(InputTraceSetting, payload, sizeof(payload));
+}
+
+unsigned long InputTraceRecorder::LostRecords() { return _active ? _active->_lostRecords : 0; }
+
+bool InputTraceRecorder::_writeRecord(InputTraceTag tag, const uint8_t *payload, uint8_t payloadSize) {
+  unsigned long now = millis();
+  unsigned long delta = now - _lastRecordMs;
+
+  uint8_t record[1 + 5 + 4];
+  uint8_t size = 0;
+
+  record[size++] = tag;
+  do {
+    uint8_t group = delta & 0x7f;
+    delta >>= 7;
+    record[size++] = delta ? (group | 0x80) : group;
+  } while (delta);
+
+  if (payloadSize > 0) {
+    memcpy(&record[size], payload, payloadSize);
+    size += payloadSize;
+  }
+
+  if (_output.availableForWrite() < size) {
+    _lostRecords++;
+    return false;
+  }
+
+  _output.write(record, size);
+  _lastRecordMs = now;
+
+  return true;
+}
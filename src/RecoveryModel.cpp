@@ -0,0 +1,84 @@
+#include "RecoveryModel.h"
+
+void RecoveryModel::Update(bool isHeatOn, bool isCoolOn, int16_t tempCentiC, unsigned long nowMs) {
+  // the temperature in the direction of the equipment being followed, rising means the equipment is winning
+  int16_t progressCentiC = _direction == RecoveryHeat ? tempCentiC : -tempCentiC;
+  bool isFollowedOn = _direction == RecoveryHeat ? isHeatOn : isCoolOn;
+
+  switch (_phase) {
+    case Running:
+      if (isFollowedOn) {
+        if (progressCentiC < _extremeCentiC) {
+          _extremeCentiC = progressCentiC;
+          _extremeMs = nowMs;
+        }
+        return;
+      }
+
+      _learn(_undershootCentiC[_direction], _referenceCentiC - _extremeCentiC, _direction * 3 + 1);
+
+      // from the lowest point, the time before it is the equipment warming up
+      if (nowMs - _extremeMs >= MinRateRunMs && progressCentiC > _extremeCentiC) {
+        int32_t rate = (int32_t)(progressCentiC - _extremeCentiC) * 3600 / (int32_t)((nowMs - _extremeMs) / 1000);
+        _learn(_rateCentiCPerHour[_direction], rate > 32767 ? 32767 : (int16_t)rate, _direction * 3);
+      }
+
+      _phase = Coasting;
+      _referenceCentiC = progressCentiC;
+      _extremeCentiC = progressCentiC;
+      _phaseStartMs = nowMs;
+      return;
+    case Coasting:
+      if (progressCentiC > _extremeCentiC)
+        _extremeCentiC = progressCentiC;
+
+      if (!isHeatOn && !isCoolOn && progressCentiC > _extremeCentiC - CoastEndCentiC
+          && nowMs - _phaseStartMs < MaxCoastMs)
+        return;
+
+      _learn(_overshootCentiC[_direction], _extremeCentiC - _referenceCentiC, _direction * 3 + 2);
+      if (_learnedCycles[_direction] < 255)
+        _learnedCycles[_direction]++;
+
+      _phase = Idle;
+      break;
+    case Idle:
+    default:
+      break;
+  }
+
+  if (isHeatOn)
+    _startRun(RecoveryHeat, tempCentiC, nowMs);
+  else if (isCoolOn)
+    _startRun(RecoveryCool, tempCentiC, nowMs);
+}
+
+int16_t RecoveryModel::RateCentiCPerHour(RecoveryDirection direction) const { return _rateCentiCPerHour[direction]; }
+
+int16_t RecoveryModel::UndershootCentiC(RecoveryDirection direction) const { return _undershootCentiC[direction]; }
+
+int16_t RecoveryModel::OvershootCentiC(RecoveryDirection direction) const { return _overshootCentiC[direction]; }
+
+uint8_t RecoveryModel::LearnedCycles(RecoveryDirection direction) const { return _learnedCycles[direction]; }
+
+void RecoveryModel::_learn(int16_t & average, int16_t sample, uint8_t bit) {
+  uint8_t mask = 1 << bit;
+
+  if (!(_learnedMask & mask)) {
+    average = sample;
+    _learnedMask |= mask;
+    return;
+  }
+
+  // a quarter of the way to each new sample, about the last four cycles
+  average += ((int32_t)sample - average) / 4;
+}
+
+void RecoveryModel::_startRun(RecoveryDirection direction, int16_t tempCentiC, unsigned long nowMs) {
+  _phase = Running;
+  _direction = direction;
+  _referenceCentiC = direction == RecoveryHeat ? tempCentiC : -tempCentiC;
+  _extremeCentiC = _referenceCentiC;
+  _phaseStartMs = nowMs;
+  _extremeMs = nowMs;
+}
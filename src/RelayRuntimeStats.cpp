@@ -0,0 +1,74 @@
+#include "RelayRuntimeStats.h"
+
+bool RelayRuntimeStats::Update(bool isOn, unsigned long nowMs) {
+  if (isOn == _isOn) return false;
+
+  _isOn = isOn;
+
+  if (isOn) {
+    _onSinceMs = nowMs;
+    _totals.cycles++;
+    _countCycleStart(nowMs);
+    return true;
+  }
+
+  uint32_t runSeconds = (nowMs - _onSinceMs + 500) / 1000;
+  _totals.onSeconds += runSeconds;
+
+  if (runSeconds > _totals.longestRunSeconds)
+    _totals.longestRunSeconds = runSeconds;
+
+  if (_totals.shortestRunSeconds == 0 || runSeconds < _totals.shortestRunSeconds)
+    _totals.shortestRunSeconds = runSeconds;
+
+  return true;
+}
+
+bool RelayRuntimeStats::IsOn() const { return _isOn; }
+
+const RelayRuntimeTotals & RelayRuntimeStats::Totals() const { return _totals; }
+
+uint32_t RelayRuntimeStats::OnSeconds(unsigned long nowMs) const {
+  if (!_isOn) return _totals.onSeconds;
+
+  return _totals.onSeconds + (nowMs - _onSinceMs + 500) / 1000;
+}
+
+uint16_t RelayRuntimeStats::CyclesPerHour(unsigned long nowMs) const {
+  unsigned long quarter = nowMs / BucketMs;
+
+  // nothing recent enough, or millis wrapped since the last cycle
+  if (quarter < _newestQuarter || quarter - _newestQuarter >= WindowBuckets) return 0;
+
+  uint16_t cycles = 0;
+  uint8_t age;
+
+  // the buckets still in the window are the newest one and those before it, up to the window length from now
+  for (age = 0; age < WindowBuckets - (quarter - _newestQuarter) && age <= _newestQuarter; age++)
+    cycles += _bucketCycles[(_newestQuarter - age) % WindowBuckets];
+
+  return cycles;
+}
+
+void RelayRuntimeStats::Restore(const RelayRuntimeTotals & totals) {
+  _totals = totals;
+}
+
+void RelayRuntimeStats::_countCycleStart(unsigned long nowMs) {
+  unsigned long quarter = nowMs / BucketMs;
+
+  if (quarter < _newestQuarter || quarter - _newestQuarter >= WindowBuckets) {
+    // the whole window is stale, or millis wrapped
+    uint8_t i;
+    for (i = 0; i < WindowBuckets; i++)
+      _bucketCycles[i] = 0;
+  }
+  else {
+    unsigned long cleared;
+    for (cleared = _newestQuarter + 1; cleared <= quarter; cleared++)
+      _bucketCycles[cleared % WindowBuckets] = 0;
+  }
+
+  _newestQuarter = quarter;
+  _bucketCycles[quarter % WindowBuckets]++;
+}
@@ -0,0 +1,64 @@
+#include "RuntimeStore.h"
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+#include <EEPROM.h>
+
+void RuntimeStore::_beginEeprom() {
+#ifdef ARDUINO_ARCH_ESP32
+  static bool isBegun = false;
+
+  if (!isBegun)
+    isBegun = EEPROM.begin(sizeof(uint16_t) + sizeof(uint8_t) + _maxCount * sizeof(RelayRuntimeTotals));
+#endif
+}
+
+bool RuntimeStore::Load(RelayRuntimeTotals *totals, uint8_t count) {
+  if (count > _maxCount) return false;
+
+  _beginEeprom();
+
+  uint16_t magic;
+  uint8_t savedCount;
+  int address = _address;
+
+  EEPROM.get(address, magic);
+  address += sizeof(magic);
+  EEPROM.get(address, savedCount);
+  address += sizeof(savedCount);
+
+  if (magic != _magic || savedCount != count) return false;
+
+  uint8_t i;
+  for (i = 0; i < count; i++) {
+    EEPROM.get(address, totals[i]);
+    address += sizeof(RelayRuntimeTotals);
+  }
+
+  return true;
+}
+
+void RuntimeStore::Save(const RelayRuntimeTotals *totals, uint8_t count) {
+  if (count > _maxCount) return;
+
+  _beginEeprom();
+
+  int address = _address;
+  uint16_t magic = _magic;
+
+  EEPROM.put(address, magic);
+  address += sizeof(magic);
+  EEPROM.put(address, count);
+  address += sizeof(count);
+
+  uint8_t i;
+  for (i = 0; i < count; i++) {
+    EEPROM.put(address, totals[i]);
+    address += sizeof(RelayRuntimeTotals);
+  }
+
+#ifdef ARDUINO_ARCH_ESP32
+  EEPROM.commit();
+#endif
+}
+
+#endif
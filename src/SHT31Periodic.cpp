@@ -0,0 +1,35 @@
+#include "SHT31Periodic.h"
+
+/// The periodic start commands, by rate then repeatability
+static const uint16_t PROGMEM periodicCommands[5][3] = {
+  { 0x2032, 0x2024, 0x202F },  // 0.5 mps
+  { 0x2130, 0x2126, 0x212D },  // 1 mps
+  { 0x2236, 0x2220, 0x222B },  // 2 mps
+  { 0x2334, 0x2322, 0x2329 },  // 4 mps
+  { 0x2737, 0x2721, 0x272A },  // 10 mps
+};
+
+/// Read out the latest periodic measurement
+static const uint16_t fetchDataCommand = 0xE000;
+
+/// Stop periodic acquisition
+static const uint16_t breakCommand = 0x3093;
+
+bool SHT31Periodic::StartPeriodic(SHT31Repeatability repeatability, SHT31Rate rate) {
+  _isPeriodic = writeCmd(pgm_read_word(&periodicCommands[rate][repeatability]));
+  return _isPeriodic;
+}
+
+bool SHT31Periodic::FetchData() {
+  if (!writeCmd(fetchDataCommand)) return false;
+
+  // not fast, the CRC is checked
+  return readData(false);
+}
+
+bool SHT31Periodic::StopPeriodic() {
+  _isPeriodic = false;
+  return writeCmd(breakCommand);
+}
+
+bool SHT31Periodic::IsPeriodic() const { return _isPeriodic; }
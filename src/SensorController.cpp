@@ -6,12 +6,57 @@ float SensorController::CurrentTempC() const { return _currentTempC; }
 
 float SensorController::CurrentHumidityRel() const { return _currentHumdityRel; }
 
+float SensorController::CurrentDewPointC() const { return _currentDewPointC; }
+
+float SensorController::CurrentAbsoluteHumidity() const { return _currentAbsoluteHumidity; }
+
+float SensorController::CurrentHeatIndexC() const { return _currentHeatIndexC; }
+
+int16_t SensorController::CurrentTempTenthsC() const { return _currentTempTenthsC; }
+
+int16_t SensorController::CurrentDewPointTenthsC() const { return _currentDewPointTenthsC; }
+
+int16_t SensorController::CurrentHeatIndexTenthsC() const { return _currentHeatIndexTenthsC; }
+
+bool SensorController::IsReadingValid() const {
+  return _hasGoodRead && (millis() - _lastGoodReadMs) < _staleAfterMs;
+}
+
+unsigned long SensorController::ErrorCount() const { return _errorCount; }
+
+unsigned long SensorController::ReinitCount() const { return _reinitCount; }
+
+void SensorController::SetErrorHandling(I2cArbiter *arbiter, unsigned long staleAfterMs, uint8_t recoverAfterErrors) {
+  _arbiter = arbiter;
+  _staleAfterMs = staleAfterMs;
+  _recoverAfterErrors = recoverAfterErrors > 0 ? recoverAfterErrors : 1;
+}
+
+unsigned long SensorController::PeriodicFallbackCount() const { return _periodicFallbackCount; }
+
+void SensorController::SetPeriodicMode(SHT31Repeatability repeatability, SHT31Rate rate) {
+  _isPeriodicMode = true;
+  _periodicRepeatability = repeatability;
+  _periodicRate = rate;
+}
+
+void SensorController::SetSingleShotMode() {
+  _isPeriodicMode = false;
+}
+
 SHT31 & SensorController::Sensor() { return _sensor; }
 
 SensorController::SensorController(unsigned long sensorReadBounceMs)
-  : _readSensorDebouncer(StableDebouncer(sensorReadBounceMs)), _currentTempC(0.0), _currentHumdityRel(0.0) { }
+  : _readSensorDebouncer(StableDebouncer(sensorReadBounceMs)), _currentTempC(0.0), _currentHumdityRel(0.0),
+    _currentDewPointC(0.0), _currentAbsoluteHumidity(0.0), _currentHeatIndexC(0.0) {
+  // read on the first pass after boot so control can start right away
+  _readSensorDebouncer.SetImmediateFirstExecution(true);
+}
 
 void SensorController::Initialize() {
+    // a reset of the board alone leaves the sensor in periodic mode, where it ignores the reset in begin
+    _sensor.StopPeriodic();
+    delayMicroseconds(1000);
     _sensor.begin();
 }
     
@@ -0,0 +1,124 @@
+#include "SerialConsole.h"
+
+uint8_t ConsoleArguments::Count() const { return _count; }
+
+const char* ConsoleArguments::Get(uint8_t index) const { return index < _count ? _tokens[index] : ""; }
+
+bool ConsoleArguments::Is(uint8_t index, const char *value) const {
+  return index < _count && strcmp_P(_tokens[index], value) == 0;
+}
+
+bool ConsoleArguments::ParseTenths(uint8_t index, int16_t & tenths) const {
+  if (index >= _count) return false;
+
+  const char *cursor = _tokens[index];
+  bool isNegative = *cursor == '-';
+  if (isNegative) cursor++;
+
+  int16_t whole = 0;
+  int8_t fraction = 0;
+  bool hasDigits = false;
+
+  while (*cursor >= '0' && *cursor <= '9') {
+    whole = whole * 10 + (*cursor++ - '0');
+    hasDigits = true;
+
+    if (whole > 999) return false;
+  }
+
+  if (*cursor == '.') {
+    cursor++;
+
+    if (*cursor >= '0' && *cursor <= '9') {
+      fraction = *cursor++ - '0';
+      hasDigits = true;
+    }
+  }
+
+  if (!hasDigits || *cursor != '\0') return false;
+
+  tenths = whole * 10 + fraction;
+  if (isNegative) tenths = -tenths;
+
+  return true;
+}
+
+SerialConsole::SerialConsole(Stream & input, Print & output, const ConsoleCommand *commands, uint8_t commandCount,
+                             uint8_t maxBytesPerLoop)
+  : _input(input), _output(output), _commands(commands), _commandCount(commandCount),
+    _maxBytesPerLoop(maxBytesPerLoop) { }
+
+void SerialConsole::PrintCommands() {
+  ConsoleCommand command;
+  uint8_t i;
+
+  for (i = 0; i < _commandCount; i++) {
+    memcpy_P(&command, &_commands[i], sizeof(command));
+    _output.print(reinterpret_cast<const __FlashStringHelper *>(command.name));
+    _output.print(' ');
+  }
+
+  _output.println();
+}
+
+void SerialConsole::LoopHandler() {
+  uint8_t consumed;
+
+  for (consumed = 0; consumed < _maxBytesPerLoop && _input.available() > 0; consumed++) {
+    int character = _input.read();
+    if (character < 0) break;
+
+    if (character == '\r' || character == '\n') {
+      if (_isOverflowed)
+        _output.println(F("line too long"));
+      else if (_length > 0) {
+        _buffer[_length] = '\0';
+        _dispatch();
+      }
+
+      _length = 0;
+      _isOverflowed = false;
+
+      // one command per loop keeps the worst case bounded by the slowest handler
+      break;
+    }
+
+    if (_length < BufferSize - 1)
+      _buffer[_length++] = (char)character;
+    else
+      _isOverflowed = true;
+  }
+}
+
+void SerialConsole::_dispatch() {
+  ConsoleArguments args;
+  char *cursor = _buffer;
+
+  while (*cursor != '\0' && args._count < ConsoleArguments::MaxTokens) {
+    while (*cursor == ' ' || *cursor == '\t') *cursor++ = '\0';
+    if (*cursor == '\0') break;
+
+    args._tokens[args._count++] = cursor;
+    while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t') cursor++;
+  }
+
+  // anything past the last token we keep is ignored
+  *cursor = '\0';
+
+  if (args._count == 0) return;
+
+  ConsoleCommand command;
+  uint8_t i;
+
+  for (i = 0; i < _commandCount; i++) {
+    memcpy_P(&command, &_commands[i], sizeof(command));
+
+    if (args.Is(0, command.name)) {
+      command.handler(args, _output);
+      return;
+    }
+  }
+
+  _output.print(F("unknown command: "));
+  _output.println(args.Get(0));
+}
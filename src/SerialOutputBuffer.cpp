@@ -0,0 +1,58 @@
+#include "SerialOutputBuffer.h"
+
+SerialOutputBuffer::SerialOutputBuffer(Print & output, SerialOverflowPolicy policy)
+  : _output(output), _policy(policy) { }
+
+size_t SerialOutputBuffer::write(uint8_t value) {
+  if (_count == BufferSize) {
+    _droppedBytes++;
+
+    if (_policy == DropNewest) return 1;
+
+    _head = (_head + 1) % BufferSize;
+    _count--;
+  }
+
+  _buffer[(_head + _count) % BufferSize] = value;
+  _count++;
+
+  if (_count > _highWaterMark) _highWaterMark = _count;
+
+  return 1;
+}
+
+size_t SerialOutputBuffer::write(const uint8_t *buffer, size_t size) {
+  size_t i;
+
+  for (i = 0; i < size; i++)
+    write(buffer[i]);
+
+  return size;
+}
+
+int SerialOutputBuffer::availableForWrite() { return BufferSize - _count; }
+
+unsigned long SerialOutputBuffer::DroppedBytes() const { return _droppedBytes; }
+
+uint16_t SerialOutputBuffer::HighWaterMark() const { return _highWaterMark; }
+
+void SerialOutputBuffer::ResetCounters() {
+  _droppedBytes = 0;
+  _highWaterMark = _count;
+}
+
+void SerialOutputBuffer::LoopHandler() {
+  if (_count == 0) return;
+
+  int room = _output.availableForWrite();
+  if (room <= 0) return;
+
+  // hand over the contiguous run up to the end of the ring, the wrapped part goes out on the next loop
+  uint16_t contiguous = _head + _count > BufferSize ? BufferSize - _head : _count;
+  uint16_t length = (uint16_t)room < contiguous ? (uint16_t)room : contiguous;
+
+  _output.write(&_buffer[_head], length);
+
+  _head = (_head + length) % BufferSize;
+  _count -= length;
+}
@@ -0,0 +1,28 @@
+#include "SettingCommandSlot.h"
+
+bool SettingCommandSlot::Post(const SettingCommand & command) {
+  if (_isFull) return false;
+
+  _command = command;
+  _postedCount++;
+
+  __sync_synchronize();
+  _isFull = true;
+  return true;
+}
+
+bool SettingCommandSlot::Take(SettingCommand & command) {
+  if (!_isFull) return false;
+  __sync_synchronize();
+
+  command = _command;
+  _takenCount = _takenCount + 1;
+
+  __sync_synchronize();
+  _isFull = false;
+  return true;
+}
+
+uint16_t SettingCommandSlot::PostedCount() const { return _postedCount; }
+
+uint16_t SettingCommandSlot::TakenCount() const { return _takenCount; }
@@ -2,38 +2,58 @@
 #include "StableDebouncer.h"
 #include "SettingsController.h"
 
-float SettingsController::SetHeatTempC() const { return _setHeatTempC; }
+float SettingsController::SetHeatTempC() const { return _setHeatTenthsC * 0.1f; }
 
-float SettingsController::SetCoolTempC() const { return _setCoolTempC; }
+float SettingsController::SetCoolTempC() const { return _setCoolTenthsC * 0.1f; }
+
+int16_t SettingsController::SetHeatTenthsC() const { return _setHeatTenthsC; }
+
+int16_t SettingsController::SetCoolTenthsC() const { return _setCoolTenthsC; }
 
 ThermostatTemperatureMode SettingsController::CurrentTempMode() { return _tempMode; }
 
 ThermostatHvacMode SettingsController::CurrentHeatMode() { return _heatMode; }
 
-const char* SettingsController::GetHeatModeString() {
-  switch (_heatMode) {
-    case Off: return "Off";
-    case Heat: return "Heat";
-    case Cool: return "Cool";
-    default: return "Unknown State";
+const __FlashStringHelper* SettingsController::GetHeatModeString() { return HeatModeString(_heatMode); }
+
+const __FlashStringHelper* SettingsController::HeatModeString(ThermostatHvacMode heatMode) {
+  switch (heatMode) {
+    case Off: return F("Off");
+    case Heat: return F("Heat");
+    case Cool: return F("Cool");
+    default: return F("Unknown State");
   }
 }
 
 SettingsController::SettingsController(StableDebouncer incrementBouncer, StableDebouncer decrementBouncer,
-                                       PinController upButtonController, PinController downButtonController,
-                                       PinController modeButtonController)
+                                       UpButtonPin upButtonController, DownButtonPin downButtonController,
+                                       HeatModeButtonPin modeButtonController, TempModeButtonPin tempModeButtonController)
  : _incrementBouncer(incrementBouncer), _decrementBouncer(decrementBouncer), _upButton(upButtonController),
-   _downButton(downButtonController), _modeButton(modeButtonController) {
+   _downButton(downButtonController), _modeButton(modeButtonController), _tempModeButton(tempModeButtonController) {
     _setHeatModeBouncer.SetStickyBounce(true);
     _setHeatModeBouncer.SetStartDelay(10);
     _setHeatModeBouncer.SetStopDelay(10);
     _setHeatModeBouncer.SetResetCooldown(10);
+
+    _setTempModeBouncer.SetStickyBounce(true);
+    _setTempModeBouncer.SetStartDelay(10);
+    _setTempModeBouncer.SetStopDelay(10);
+    _setTempModeBouncer.SetResetCooldown(10);
+}
+
+void SettingsController::SetIncrementAcceleration(HoldAcceleration acceleration) {
+  _incrementAcceleration = acceleration;
+}
+
+void SettingsController::SetDecrementAcceleration(HoldAcceleration acceleration) {
+  _decrementAcceleration = acceleration;
 }
 
 void SettingsController::Initialize() {
     _upButton.Initialize();
     _downButton.Initialize();
     _modeButton.Initialize();
+    _tempModeButton.Initialize();
 }
 
 void SettingsController::IncrementSetTempC() {
@@ -51,25 +71,99 @@ void SettingsController::ToggleHeatMode() {
   _setHeatModeBouncer.Execute(wrapper);
 }
 
+void SettingsController::ToggleTempMode() {
+  auto wrapper = [this]() { _tempModeToggle(); };
+  _setTempModeBouncer.Execute(wrapper);
+}
+
+void SettingsController::ChangeHeatTenthsC(int16_t setTenthsC) {
+  _setHeatTenthsC = _clampSetTenthsC(setTenthsC);
+}
+
+void SettingsController::ChangeCoolTenthsC(int16_t setTenthsC) {
+  _setCoolTenthsC = _clampSetTenthsC(setTenthsC);
+}
+
+void SettingsController::ChangeHeatMode(ThermostatHvacMode heatMode) {
+  _heatMode = heatMode;
+}
+
+void SettingsController::ChangeTempMode(ThermostatTemperatureMode tempMode) {
+  _tempMode = tempMode;
+}
+
+void SettingsController::ApplyCommand(const SettingCommand & command) {
+#ifdef THERMOSTAT_TRACE_RECORD
+  InputTraceRecorder::RecordSetting(command.kind, command.value);
+#endif
+
+  switch(command.kind) {
+    case SettingHeatSetpoint:
+      ChangeHeatTenthsC(command.value);
+      break;
+    case SettingCoolSetpoint:
+      ChangeCoolTenthsC(command.value);
+      break;
+    case SettingHeatMode:
+      ChangeHeatMode((ThermostatHvacMode)command.value);
+      break;
+    case SettingTempMode:
+      ChangeTempMode((ThermostatTemperatureMode)command.value);
+      break;
+  }
+}
+
+uint16_t SettingsController::InputEdgeCount() const { return _inputEdgeCount; }
+
+void SettingsController::SetInputLocked(bool isLocked) { _isInputLocked = isLocked; }
+
 void SettingsController::LoopHandler() {
-  if(_upButton.IsOn()){
+  uint8_t levels = (_upButton.IsOn() ? 1 : 0) | (_downButton.IsOn() ? 2 : 0) | (_modeButton.IsOn() ? 4 : 0)
+                   | (_tempModeButton.IsOn() ? 8 : 0);
+
+  // a press that lands while locked is ignored until every button is up, even if input unlocks while it is held
+  if(_isInputLocked && levels != 0)
+    _isPressIgnored = true;
+  else if(levels == 0)
+    _isPressIgnored = false;
+
+  uint8_t actedLevels = _isPressIgnored ? 0 : levels;
+
+  if(actedLevels & 1) {
+    _incrementMultiplier = _incrementAcceleration.Update(_incrementBouncer);
     IncrementSetTempC();
   } 
   else {
     _incrementBouncer.Reset();
+    _incrementAcceleration.Reset(_incrementBouncer);
   }
   
-  if(_downButton.IsOn()) {
+  if(actedLevels & 2) {
+    _decrementMultiplier = _decrementAcceleration.Update(_decrementBouncer);
     DecrementSetTempC();
   }
   else {
     _decrementBouncer.Reset();
+    _decrementAcceleration.Reset(_decrementBouncer);
   }
 
-  if(_modeButton.IsOn()) {
+  if(actedLevels & 4) {
     ToggleHeatMode();
   }
   else {
     _setHeatModeBouncer.Reset();
   }
+
+  if(actedLevels & 8) {
+    ToggleTempMode();
+  }
+  else {
+    _setTempModeBouncer.Reset();
+  }
+
+  // any press or release counts as input, for waking the display
+  if(levels != _buttonLevels) {
+    _buttonLevels = levels;
+    _inputEdgeCount++;
+  }
 }
@@ -7,25 +7,33 @@
 StableDebouncer::StableDebouncer() : StableDebouncer(DefaultFrequencyMilliseconds) { }
 
 StableDebouncer::StableDebouncer(unsigned long executeFrequencyMs) {
-  _executeFrequencyMs = executeFrequencyMs;
+  _executeFrequencyMs = _toDuration(executeFrequencyMs);
+}
+
+void StableDebouncer::SetExecuteFrequency(unsigned long executeFrequencyMs) {
+  _executeFrequencyMs = _toDuration(executeFrequencyMs);
 }
 
 void StableDebouncer::SetStartDelay(unsigned long startDelayMs) {
-    _debounceStartExecuteDelayMs = startDelayMs;
+    _debounceStartExecuteDelayMs = _toDuration(startDelayMs);
 }
 
 void StableDebouncer::SetStopDelay(unsigned long stopDelayMs) {
-    _debounceStopExecuteDelayMs = stopDelayMs;
+    _debounceStopExecuteDelayMs = _toDuration(stopDelayMs);
 }
 
 void StableDebouncer::SetResetCooldown(unsigned long debounceResetCooldownMs) {
-  _debounceResetCooldownMs = debounceResetCooldownMs;
+  _debounceResetCooldownMs = _toDuration(debounceResetCooldownMs);
 }
 
 void StableDebouncer::SetStickyBounce(bool stickyBounce) {
     _isStickyBounce = stickyBounce;
 }
 
+void StableDebouncer::SetImmediateFirstExecution(bool isImmediate) {
+    _isFirstExecutionImmediate = isImmediate;
+}
+
 void StableDebouncer::Reset() {
     if(_state != Idle)
         _advanceReset();
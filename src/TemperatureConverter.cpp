@@ -0,0 +1,88 @@
+#include "TemperatureConverter.h"
+
+/// Tenths farenheit for every whole degree celcius from -40C to 60C
+static constexpr int16_t PROGMEM wholeCToTenthsF[] = {
+    -400, -382, -364, -346, -328, -310, -292, -274, -256, -238, -220, -202, -184, -166, -148, -130, -112,
+    -94, -76, -58, -40, -22, -4, 14, 32, 50, 68, 86, 104, 122, 140, 158, 176, 194, 212, 230, 248, 266, 284,
+    302, 320, 338, 356, 374, 392, 410, 428, 446, 464, 482, 500, 518, 536, 554, 572, 590, 608, 626, 644, 662,
+    680, 698, 716, 734, 752, 770, 788, 806, 824, 842, 860, 878, 896, 914, 932, 950, 968, 986, 1004, 1022,
+    1040, 1058, 1076, 1094, 1112, 1130, 1148, 1166, 1184, 1202, 1220, 1238, 1256, 1274, 1292, 1310, 1328,
+    1346, 1364, 1382, 1400
+};
+
+/// Rounded tenths farenheit for each tenth of a degree celcius
+static constexpr uint8_t PROGMEM fractionCToTenthsF[] = { 0, 2, 4, 5, 7, 9, 11, 13, 14, 16 };
+
+/// Rounded tenths celcius for every whole farenheit setpoint from 40F to 95F
+static constexpr int16_t PROGMEM wholeFToTenthsC[] = {
+    44, 50, 56, 61, 67, 72, 78, 83, 89, 94, 100, 106, 111, 117, 122, 128, 133, 139, 144, 150, 156, 161,
+    167, 172, 178, 183, 189, 194, 200, 206, 211, 217, 222, 228, 233, 239, 244, 250, 256, 261, 267, 272,
+    278, 283, 289, 294, 300, 306, 311, 317, 322, 328, 333, 339, 344, 350
+};
+
+static_assert(sizeof(wholeCToTenthsF) / sizeof(int16_t) ==
+              (TemperatureConverter::MaxTenthsC - TemperatureConverter::MinTenthsC) / 10 + 1,
+              "celcius table does not cover the tenths range");
+static_assert(sizeof(wholeFToTenthsC) / sizeof(int16_t) ==
+              TemperatureConverter::SetpointMaxF - TemperatureConverter::SetpointMinF + 1,
+              "farenheit table does not cover the setpoint range");
+
+int16_t TemperatureConverter::ToTenthsC(float tempC) {
+  return (int16_t)(tempC * 10.0f + (tempC < 0 ? -0.5f : 0.5f));
+}
+
+int16_t TemperatureConverter::TenthsCToTenthsF(int16_t tenthsC) {
+  if (tenthsC <= MinTenthsC) return (int16_t)pgm_read_word(&wholeCToTenthsF[0]);
+  if (tenthsC >= MaxTenthsC) return (int16_t)pgm_read_word(&wholeCToTenthsF[(MaxTenthsC - MinTenthsC) / 10]);
+
+  // offset into the table so that the whole/fraction split works the same for negative values
+  uint16_t offset = (uint16_t)(tenthsC - MinTenthsC);
+
+  return (int16_t)pgm_read_word(&wholeCToTenthsF[offset / 10]) + pgm_read_byte(&fractionCToTenthsF[offset % 10]);
+}
+
+int16_t TemperatureConverter::ToDisplayTenths(int16_t tenthsC, ThermostatTemperatureMode mode) {
+  return mode == F ? TenthsCToTenthsF(tenthsC) : tenthsC;
+}
+
+int16_t TemperatureConverter::WholeFToTenthsC(int16_t tempF) {
+  if (tempF < SetpointMinF) tempF = SetpointMinF;
+  if (tempF > SetpointMaxF) tempF = SetpointMaxF;
+
+  return (int16_t)pgm_read_word(&wholeFToTenthsC[tempF - SetpointMinF]);
+}
+
+int8_t TemperatureConverter::NearestWholeF(int16_t tenthsC) {
+  uint8_t lowIndex = 0;
+  uint8_t highIndex = SetpointMaxF - SetpointMinF;
+
+  if (tenthsC <= (int16_t)pgm_read_word(&wholeFToTenthsC[lowIndex])) return SetpointMinF;
+  if (tenthsC >= (int16_t)pgm_read_word(&wholeFToTenthsC[highIndex])) return SetpointMaxF;
+
+  while (highIndex - lowIndex > 1) {
+    uint8_t middle = (lowIndex + highIndex) / 2;
+
+    if ((int16_t)pgm_read_word(&wholeFToTenthsC[middle]) <= tenthsC) lowIndex = middle;
+    else highIndex = middle;
+  }
+
+  int16_t below = tenthsC - (int16_t)pgm_read_word(&wholeFToTenthsC[lowIndex]);
+  int16_t above = (int16_t)pgm_read_word(&wholeFToTenthsC[highIndex]) - tenthsC;
+
+  return SetpointMinF + (below <= above ? lowIndex : highIndex);
+}
+
+void TemperatureConverter::PrintTenths(Print & out, int16_t tenths) {
+  if (tenths < 0) {
+    out.print('-');
+    tenths = -tenths;
+  }
+
+  out.print(tenths / 10);
+  out.print('.');
+  out.print(tenths % 10);
+}
+
+char TemperatureConverter::UnitSymbol(ThermostatTemperatureMode mode) {
+  return mode == F ? 'F' : 'C';
+}
@@ -8,154 +8,756 @@
 #include "SensorController.h"
 #include "HvacController.h"
 #include "Display.h"
+#include "SerialConsole.h"
+#include "SerialOutputBuffer.h"
+#include "InputTrace.h"
+#include "I2cBus.h"
+#include "I2cArbiter.h"
+#include "ControlSnapshot.h"
+#include "SettingCommandSlot.h"
+#include "HistoryStore.h"
+#include "ThermostatConfig.h"
+
+/// the shared I2C bus of the sensor and the display
+I2cBus i2cBus(Wire, Pins::I2cSda, Pins::I2cScl, i2cClockHz, i2cTimeoutMs);
+
+/// every transaction on the shared bus goes through here, so bus time is accounted per client
+I2cArbiter i2cArbiter(i2cBus);
 
-/* **************************
- * Settings
- */
-
-#ifdef ESP32_S2_DEV
-#define PIN_I2C_SCL 18
-#define PIN_I2C_SDA 21
-
-#define PIN_BUTTON_UP 39
-#define PIN_BUTTON_DOWN 40
-#define PIN_TEMP_MODE_TOGGLE 37
-#define PIN_HEAT_MODE_TOGGLE 38
-
-// outputs
-#define PIN_LED_HEAT 4
-#define PIN_LED_COOL 5
-#define PIN_LED_FAN 6
-
-//#elif SEEED
-//#define PIN_BUTTON_UP 10
-//#define PIN_BUTTON_DOWN 9
-//#define PIN_TEMP_MODE_TOGGLE 8
-//#define PIN_HEAT_MODE_TOGGLE 7
-//
-//// outputs
-//#define PIN_LED_HEAT 0
-//#define PIN_LED_COOL 1
-//#define PIN_LED_FAN 2
+// controllers
+SettingsController settingsController = SettingsController(
+        StableDebouncer(buttonDebounceMs), StableDebouncer(buttonDebounceMs),
+        UpButtonPin(), DownButtonPin(), HeatModeButtonPin(), TempModeButtonPin());
+SensorController sensorController = SensorController(sensorReadBounceMs);
+HvacController hvacController = HvacController(
+        hvacChangeDebounceMs, hvacOnBufferC, CoolRelayPin(), HeatRelayPin(), FanRelayPin());
+
+// the same clock during and after display transfers, so the display driver never drops the shared bus out of Fast-mode
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET, i2cClockHz, i2cClockHz);
+StarfallDriver starfallDriver(&display, 200);
+
+/// all serial output goes through this buffer so a slow port never blocks the loop
+SerialOutputBuffer serialOutput(Serial, serialOverflowPolicy);
+
+/// debouncer to control the frequency of writing to the serial console
+StableDebouncer writeDebouncer = StableDebouncer(writeDebounceMs);
+
+#ifdef THERMOSTAT_TRACE_RECORD
+/// records sensor readings, button edges and console setting changes to the serial port for replay on the host,
+/// text output would corrupt the trace so telemetry starts off and the banner is skipped
+InputTraceRecorder inputTraceRecorder(serialOutput);
+
+/// Drops everything written to it, console replies and status lines go here while the port carries the trace
+class SilentOutput : public Print {
+  public:
+    size_t write(uint8_t value) override { return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { return size; }
+    int availableForWrite() override { return 255; }
+};
 
+/// where console replies and the status line go
+SilentOutput consoleOutput;
+
+/// Whether the periodic status line is written to the serial console
+bool isTelemetryOn = false;
 #else
-#define PIN_BUTTON_UP 21
-#define PIN_BUTTON_DOWN 20
-#define PIN_TEMP_MODE_TOGGLE 19
-#define PIN_HEAT_MODE_TOGGLE 18
+/// where console replies and the status line go
+Print & consoleOutput = serialOutput;
 
-// outputs
-#define PIN_LED_HEAT 4
-#define PIN_LED_COOL 5
-#define PIN_LED_FAN 6
+/// Whether the periodic status line is written to the serial console
+bool isTelemetryOn = true;
 #endif
 
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
-#define OLED_RESET -1
-#define SCREEN_ADDRESS 0x3c
+/// the control state the display and serial console show, published after every control step
+ControlSnapshotBuffer controlSnapshot;
 
-/// The increment of an up/down button press in celcius mode
-const float tempIncrementC = 0.5;
+/// console setting changes on their way to the control step, the settings are only ever written from there
+SettingCommandSlot settingCommands;
 
-/// The default temperature setting for heating in celcius mode
-const float defaultHeatTempC = 21.0;
+/// the relay counters and learned recovery, copied by the control step when the runtime command asks
+ReportExchange<RuntimeReport> runtimeReports;
 
-/// the default temperature setting for cooling in celcius mode
-const float defaultCoolTempC = 21.0;
+/// the loop, sensor and bus counters, copied and reset by the control step when the stats command asks
+ReportExchange<StatsReport> statsReports;
 
-/// the amount to over cool or over heat in celcius mode, helps to prevent too many on/off events
-const float hvacOnBufferC = 0.5;
+/// The console replies that wait for the control step to apply a setting change
+enum ConsoleReply : uint8_t {
+  ReplyNone = 0,
+  ReplySetpoints = 1,  // the heating and cooling setpoints
+  ReplyHeatMode = 2,   // the HVAC mode
+  ReplyTempMode = 3,   // the temperature unit
+};
 
-/// The time in milliseconds to wait between HVAC relay state changes, do not set this too low, or you could damage the equipment
-const unsigned long hvacChangeDebounceMs = 5000;  // 5 seconds
+/// The reply to write once the last posted setting change shows up in the snapshot
+ConsoleReply pendingReply = ReplyNone;
 
-/// The time in milliseconds to wait between writing status information to the serial console
-const unsigned long writeDebounceMs = 1000;  // 1 second
+#ifndef THERMOSTAT_MEMORY_LEAN
+/// downsampled readings and relay changes, kept for export with the history command
+HistoryStore historyStore(historyIntervalMs);
+#endif
 
-/// The time in milliseconds to execute the button action on a continuous press
-const unsigned long buttonDebounceMs = 1000;  // 1 second
+/// The number of loop passes since the stats were last dumped, control steps when split into tasks
+unsigned long loopCount = 0;
 
-/// The time in milliseconds between reads of the temperature sensor
-const unsigned long sensorReadBounceMs = 500;  // .5 seconds
+/// The longest loop pass in microseconds since the stats were last dumped, control steps when split into tasks
+unsigned long maxLoopMicros = 0;
 
-/* *************************************
- * End settings
- */
+#ifdef THERMOSTAT_RTOS_TASKS
+/// The furthest a control step started from its fixed period in microseconds since the stats were last dumped
+unsigned long maxControlJitterMicros = 0;
 
-// controllers
-SettingsController settingsController = SettingsController(
-        StableDebouncer(buttonDebounceMs), StableDebouncer(buttonDebounceMs),
-        PinController(PIN_BUTTON_UP, INPUT),PinController(PIN_BUTTON_DOWN, INPUT),
-        PinController(PIN_HEAT_MODE_TOGGLE, INPUT));
-SensorController sensorController = SensorController(sensorReadBounceMs);
-HvacController hvacController = HvacController(hvacChangeDebounceMs, PIN_LED_COOL, PIN_LED_HEAT, PIN_LED_FAN);
+/// Task running the settings, sensor and HVAC at a fixed period
+void controlTask(void *parameters);
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
-StarfallDriver starfallDriver(&display, 200);
+/// Task running the display and serial console whenever the control task is idle
+void uiTask(void *parameters);
+#endif
 
-/// debouncer to control the frequency of writing to the serial console
-StableDebouncer writeDebouncer = StableDebouncer(writeDebounceMs);
+/// The stages of bringing up everything control does not need, run from the UI side one stage per pass once control
+/// is already running
+enum StartupStage : uint8_t {
+  StartupSerial = 0,     // open the port and queue the banner
+  StartupDisplay = 1,    // allocate the framebuffer and run the display init sequence
+  StartupAnimation = 2,  // seed the animation and hook up the overlay
+  StartupHistory = 3,    // mount the history storage, recording starts after
+  StartupDone = 4,
+};
+
+/// The next startup stage to run
+StartupStage startupStage = StartupSerial;
+
+/// The sensor status register read at boot, before periodic acquisition starts
+uint16_t sensorBootStatus = 0;
+
+/// The button edge count the display last woke for
+uint16_t lastInputEdgeCount = 0;
+
+/// Whether the time to the first control decision has been written to the console
+bool isFirstDecisionReported = false;
+
+/// Run the next startup stage
+void startupStep();
+
+/// Run the settings, sensor and HVAC behaviors, then publish the result for the UI
+void controlStep();
+
+/// Run the display and serial behaviors, these only see the control side through the snapshot
+void uiStep();
 
 /// The status writer for the information to the serial port
 void statusWriter();
 
+void helpCommand(const ConsoleArguments & args, Print & out);
+void getCommand(const ConsoleArguments & args, Print & out);
+void setCommand(const ConsoleArguments & args, Print & out);
+void modeCommand(const ConsoleArguments & args, Print & out);
+void unitCommand(const ConsoleArguments & args, Print & out);
+void statsCommand(const ConsoleArguments & args, Print & out);
+void runtimeCommand(const ConsoleArguments & args, Print & out);
+void telemetryCommand(const ConsoleArguments & args, Print & out);
+#ifndef THERMOSTAT_MEMORY_LEAN
+void historyCommand(const ConsoleArguments & args, Print & out);
+#endif
+
+const char helpCommandName[] PROGMEM = "help";
+const char getCommandName[] PROGMEM = "get";
+const char setCommandName[] PROGMEM = "set";
+const char modeCommandName[] PROGMEM = "mode";
+const char unitCommandName[] PROGMEM = "unit";
+const char statsCommandName[] PROGMEM = "stats";
+const char runtimeCommandName[] PROGMEM = "runtime";
+const char telemetryCommandName[] PROGMEM = "telemetry";
+#ifndef THERMOSTAT_MEMORY_LEAN
+const char historyCommandName[] PROGMEM = "history";
+#endif
+
+/// The serial console commands
+const ConsoleCommand consoleCommands[] PROGMEM = {
+  { helpCommandName, helpCommand },            // help
+  { getCommandName, getCommand },              // get
+  { setCommandName, setCommand },              // set heat|cool <temperature in the current unit>
+  { modeCommandName, modeCommand },            // mode off|heat|cool
+  { unitCommandName, unitCommand },            // unit c|f
+  { statsCommandName, statsCommand },          // stats
+  { runtimeCommandName, runtimeCommand },      // runtime
+  { telemetryCommandName, telemetryCommand },  // telemetry on|off
+#ifndef THERMOSTAT_MEMORY_LEAN
+  { historyCommandName, historyCommand },      // history
+#endif
+};
+
+SerialConsole serialConsole(Serial, consoleOutput, consoleCommands, sizeof(consoleCommands) / sizeof(consoleCommands[0]),
+                            consoleBytesPerLoop);
+
+/// Hand a setting change to the control step, the reply is written once the change shows up in the snapshot
+void postSettingCommand(Print & out, SettingCommandKind kind, int16_t value, ConsoleReply reply);
+
+/// Write a console reply from a snapshot
+void printReply(Print & out, ConsoleReply reply, const ControlSnapshot & snapshot);
+
+/// Print the runtime counters of one relay
+void printRelayRuntime(Print & out, const __FlashStringHelper *name, const RelayRuntimeStats & stats,
+                       unsigned long nowMs);
+
+/// Print what has been learned about one direction of the heating and cooling system
+void printRecovery(Print & out, const __FlashStringHelper *name, const RecoveryModel & model,
+                   RecoveryDirection direction);
+
+/// Print the stats line from the control side counters, the snapshot and the UI side counters, then reset the UI side
+/// counters, the control step has already reset its own
+void printStats(Print & out, const StatsReport & report, const ControlSnapshot & snapshot);
+
+/// Print a canonical tenths celcius value in a temperature mode
+void printTemperature(Print & out, int16_t tenthsC, ThermostatTemperatureMode mode);
+
+/// The status text drawn over the display animation
+void statusOverlay(Adafruit_SSD1306 & screen);
+
 void setup() {
-  // set up all the pins
-  pinMode(PIN_BUTTON_UP, INPUT);
-  pinMode(PIN_BUTTON_DOWN, INPUT);
-  pinMode(PIN_TEMP_MODE_TOGGLE, INPUT);
-  pinMode(PIN_HEAT_MODE_TOGGLE, INPUT);
-  pinMode(PIN_LED_HEAT, OUTPUT);
-  pinMode(PIN_LED_COOL, OUTPUT);
-  pinMode(PIN_LED_FAN, OUTPUT);
-
-  // write headers to the serial console
-  Serial.begin(9600);
-  Serial.println(__FILE__);
-  Serial.print("Library version: \t");
-  Serial.println(SHT31_LIB_VERSION);
-
-#if defined(PIN_I2C_SCL) && defined(PIN_I2C_SDA)
-  Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL, 100000);
-#else
-  Wire.begin();
-  Wire.setClock(100000);
+  // set up the relay pins first, every relay off, the buttons are set up with the settings
+  hvacController.Initialize();
+
+#ifdef THERMOSTAT_TRACE_RECORD
+  // only queued, the port opens later, but the header has to go ahead of the first record
+  inputTraceRecorder.Begin();
 #endif
 
-  display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS, false, false);
+  // only what control needs runs here, the serial port and the display come up from the loop
+  i2cBus.Begin();
 
-  starfallDriver.Initialize();
-  // run any initializers
+  sensorController.SetErrorHandling(&i2cArbiter, sensorStaleAfterMs, sensorRecoverAfterErrors);
+  if(sensorPeriodicMode)
+    sensorController.SetPeriodicMode(sensorPeriodicRepeatability, sensorPeriodicRate);
   sensorController.Initialize();
+  sensorBootStatus = sensorController.Sensor().readStatus();
+  settingsController.SetIncrementAcceleration(HoldAcceleration(buttonHoldCurve, sizeof(buttonHoldCurve) / sizeof(buttonHoldCurve[0])));
+  settingsController.SetDecrementAcceleration(HoldAcceleration(buttonHoldCurve, sizeof(buttonHoldCurve) / sizeof(buttonHoldCurve[0])));
   settingsController.Initialize();
 
-  // print starting status to the console
-  Serial.print(sensorController.Sensor().readStatus(), HEX);
-  Serial.println();
+  hvacController.SetCoolMinOffTime(coolMinOffMs);
+  if(dehumidifyOnCool)
+    hvacController.EnableDehumidifyOnCool(dehumidifyMaxDewPointC, dehumidifyDewPointMarginC);
+  if(predictiveStartStop)
+    hvacController.EnablePredictiveStartStop();
+  if(adaptiveBand)
+    hvacController.EnableAdaptiveBand(hvacBandMinC, hvacBandMaxC, hvacTargetCyclesPerHour);
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+  hvacController.EnableRuntimePersistence(runtimePersistIntervalMs);
+#endif
+
+#ifdef THERMOSTAT_RTOS_TASKS
+  xTaskCreate(controlTask, "control", controlTaskStackBytes, nullptr, controlTaskPriority, nullptr);
+  xTaskCreate(uiTask, "ui", uiTaskStackBytes, nullptr, uiTaskPriority, nullptr);
+#endif
+}
+
+#ifdef THERMOSTAT_RTOS_TASKS
+void loop() {
+  // everything runs in the control and UI tasks
+  vTaskDelete(nullptr);
+}
+
+void controlTask(void *parameters) {
+  const TickType_t periodTicks = pdMS_TO_TICKS(controlPeriodMs);
+  TickType_t lastWakeTicks = xTaskGetTickCount();
+  unsigned long lastStartMicros = micros();
+
+  for(;;) {
+    vTaskDelayUntil(&lastWakeTicks, periodTicks);
+
+    unsigned long startMicros = micros();
+    unsigned long periodMicros = startMicros - lastStartMicros;
+    unsigned long jitterMicros = periodMicros > controlPeriodMs * 1000
+        ? periodMicros - controlPeriodMs * 1000
+        : controlPeriodMs * 1000 - periodMicros;
+    lastStartMicros = startMicros;
+
+    if(jitterMicros > maxControlJitterMicros)
+      maxControlJitterMicros = jitterMicros;
+
+    controlStep();
+
+    unsigned long stepMicros = micros() - startMicros;
+    if(stepMicros > maxLoopMicros)
+      maxLoopMicros = stepMicros;
+    loopCount++;
+  }
 }
 
+void uiTask(void *parameters) {
+  for(;;) {
+    uiStep();
+
+    // a tick of rest so the idle task can run
+    vTaskDelay(1);
+  }
+}
+#else
 void loop() {
+  unsigned long loopStartMicros = micros();
+
+  controlStep();
+  uiStep();
+
+  unsigned long loopMicros = micros() - loopStartMicros;
+  if(loopMicros > maxLoopMicros)
+    maxLoopMicros = loopMicros;
+  loopCount++;
+}
+#endif
+
+void controlStep() {
+  // console changes land here so the settings are only ever written from the control side
+  SettingCommand command;
+  if(settingCommands.Take(command))
+    settingsController.ApplyCommand(command);
+
   // execute the behavior loops
   settingsController.LoopHandler();
   sensorController.LoopHandler();
   hvacController.LoopHandler(sensorController, settingsController);
 
+  ControlSnapshot snapshot;
+  snapshot.tempTenthsC = sensorController.CurrentTempTenthsC();
+  snapshot.dewPointTenthsC = sensorController.CurrentDewPointTenthsC();
+  snapshot.heatIndexTenthsC = sensorController.CurrentHeatIndexTenthsC();
+  snapshot.setHeatTenthsC = settingsController.SetHeatTenthsC();
+  snapshot.setCoolTenthsC = settingsController.SetCoolTenthsC();
+  snapshot.inputEdgeCount = settingsController.InputEdgeCount();
+  snapshot.coolCyclesPerHour = hvacController.CoolStats().CyclesPerHour(millis());
+  snapshot.heatCyclesPerHour = hvacController.HeatStats().CyclesPerHour(millis());
+  snapshot.hysteresisBandCentiC = (int16_t)(hvacController.HysteresisBandC() * 100.0f + 0.5f);
+  snapshot.sensorNoiseCentiC = (int16_t)(hvacController.SensorNoiseC() * 100.0f + 0.5f);
+  snapshot.settingCommandCount = settingCommands.TakenCount();
+  snapshot.humidityRel = sensorController.CurrentHumidityRel();
+  snapshot.absoluteHumidity = sensorController.CurrentAbsoluteHumidity();
+  snapshot.heatMode = settingsController.CurrentHeatMode();
+  snapshot.tempMode = settingsController.CurrentTempMode();
+  snapshot.isReadingValid = sensorController.IsReadingValid();
+  snapshot.isCoolOn = hvacController.IsCoolOn();
+  snapshot.isHeatOn = hvacController.IsHeatOn();
+  snapshot.isFanOn = hvacController.IsFanOn();
+  controlSnapshot.Publish(snapshot);
+
+  RuntimeReport *report = runtimeReports.Requested();
+  if(report) {
+    report->cool = hvacController.CoolStats();
+    report->heat = hvacController.HeatStats();
+    report->fan = hvacController.FanStats();
+    report->recovery = hvacController.Recovery();
+    report->nowMs = millis();
+    runtimeReports.Fulfil();
+  }
+
+  StatsReport *stats = statsReports.Requested();
+  if(stats) {
+    stats->loopCount = loopCount;
+    stats->maxLoopMicros = maxLoopMicros;
+    stats->firstDecisionMicros = hvacController.FirstDecisionMicros();
+    stats->sensorErrors = sensorController.ErrorCount();
+    stats->sensorReinits = sensorController.ReinitCount();
+    stats->sensorFallbacks = sensorController.PeriodicFallbackCount();
+    stats->i2cRecoveries = i2cBus.RecoveryCount();
+    i2cArbiter.TakeStats(stats->i2c);
+    stats->nowMs = millis();
+
+    loopCount = 0;
+    maxLoopMicros = 0;
+#ifdef THERMOSTAT_RTOS_TASKS
+    stats->maxControlJitterMicros = maxControlJitterMicros;
+    maxControlJitterMicros = 0;
+#else
+    stats->maxControlJitterMicros = 0;
+#endif
+    statsReports.Fulfil();
+  }
+
+#ifndef THERMOSTAT_MEMORY_LEAN
+  historyStore.Record(snapshot.tempTenthsC, (uint16_t)(snapshot.humidityRel * 10.0f + 0.5f), snapshot.isReadingValid,
+      (snapshot.isCoolOn ? 0x01 : 0) | (snapshot.isHeatOn ? 0x02 : 0) | (snapshot.isFanOn ? 0x04 : 0));
+#endif
+}
+
+void startupStep() {
+  switch(startupStage) {
+    case StartupSerial:
+      Serial.begin(9600);
+#ifndef THERMOSTAT_TRACE_RECORD
+      // write headers to the serial console
+      serialOutput.println(F(__FILE__));
+      serialOutput.print(F("Library version: \t"));
+      serialOutput.println(SHT31_LIB_VERSION);
+      serialOutput.print(sensorBootStatus, HEX);
+      serialOutput.println();
+#endif
+      startupStage = StartupDisplay;
+      break;
+    case StartupDisplay:
+      i2cArbiter.Transact(DisplayClient, []() { display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS, false, false); });
+      startupStage = StartupAnimation;
+      break;
+    case StartupAnimation:
+      starfallDriver.Initialize();
+      starfallDriver.SetOverlay(statusOverlay);
+      starfallDriver.SetArbiter(&i2cArbiter, SCREEN_ADDRESS);
+      starfallDriver.SetIdleTimeout(displayIdleTimeoutMs);
+      startupStage = StartupHistory;
+      break;
+    case StartupHistory:
+#ifndef THERMOSTAT_MEMORY_LEAN
+      if(!historyStore.Begin())
+        consoleOutput.println(F("history storage failed to mount, history is off"));
+#endif
+      startupStage = StartupDone;
+      break;
+    case StartupDone:
+    default:
+      break;
+  }
+}
+
+void uiStep() {
+  if(startupStage != StartupDone) {
+    startupStep();
+    return;
+  }
+
+#ifndef THERMOSTAT_TRACE_RECORD
+  if(!isFirstDecisionReported && hvacController.FirstDecisionMicros() != 0) {
+    serialOutput.print(F("first control decision after "));
+    serialOutput.print(hvacController.FirstDecisionMicros());
+    serialOutput.println(F(" us"));
+    isFirstDecisionReported = true;
+  }
+#endif
+
+  // any button edge wakes the display
+  ControlSnapshot snapshot;
+  controlSnapshot.Read(snapshot);
+  if(snapshot.inputEdgeCount != lastInputEdgeCount) {
+    lastInputEdgeCount = snapshot.inputEdgeCount;
+    starfallDriver.Wake();
+  }
+
+  // replies to console commands the control side has since acted on
+  if(pendingReply != ReplyNone && snapshot.settingCommandCount == settingCommands.PostedCount()) {
+    printReply(consoleOutput, pendingReply, snapshot);
+    pendingReply = ReplyNone;
+  }
+
+  const RuntimeReport *report = runtimeReports.Ready();
+  if(report) {
+    printRelayRuntime(consoleOutput, F("cool"), report->cool, report->nowMs);
+    printRelayRuntime(consoleOutput, F("heat"), report->heat, report->nowMs);
+    printRelayRuntime(consoleOutput, F("fan"), report->fan, report->nowMs);
+    printRecovery(consoleOutput, F("cool_model"), report->recovery, RecoveryCool);
+    printRecovery(consoleOutput, F("heat_model"), report->recovery, RecoveryHeat);
+    runtimeReports.Release();
+  }
+
+  const StatsReport *stats = statsReports.Ready();
+  if(stats) {
+    printStats(consoleOutput, *stats, snapshot);
+    statsReports.Release();
+  }
+
   starfallDriver.LoopHandler();
 
+  // the buttons only wake a blanked display, the press that does it changes nothing
+  settingsController.SetInputLocked(starfallDriver.IsBlanked());
+
+  serialConsole.LoopHandler();
+
   // write status on a debounced interval
-  writeDebouncer.Execute(statusWriter);
+  if(isTelemetryOn)
+    writeDebouncer.Execute(statusWriter);
+
+#ifndef THERMOSTAT_MEMORY_LEAN
+  // store a completed block, and queue an export line when the buffer has room
+  historyStore.LoopHandler();
+#endif
+
+#ifdef THERMOSTAT_PERSIST_RUNTIME
+  // the control step only copies the counters, the EEPROM write happens here
+  hvacController.PersistRuntimeIfDue();
+#endif
+
+  // hand the port only what it can take without blocking
+  serialOutput.LoopHandler();
 }
 
 void statusWriter() {
-  Serial.print("\t");
-  Serial.print(sensorController.CurrentTempC(), 1);
-  Serial.print("\t");
-  Serial.print(sensorController.CurrentHumidityRel(), 1);
-  Serial.print("\t");
-  Serial.print(settingsController.GetHeatModeString());
-  Serial.print("\t");
-  Serial.print(settingsController.SetCoolTempC(), 1);
-  Serial.print("\t");
-  Serial.println(settingsController.SetHeatTempC(), 1);
-}
\ No newline at end of file
+  ControlSnapshot snapshot;
+  controlSnapshot.Read(snapshot);
+
+  consoleOutput.print('\t');
+  printTemperature(consoleOutput, snapshot.tempTenthsC, snapshot.tempMode);
+  consoleOutput.print('\t');
+  consoleOutput.print(snapshot.humidityRel, 1);
+  consoleOutput.print('\t');
+  printTemperature(consoleOutput, snapshot.dewPointTenthsC, snapshot.tempMode);
+  consoleOutput.print('\t');
+  consoleOutput.print(snapshot.absoluteHumidity, 1);
+  consoleOutput.print('\t');
+  printTemperature(consoleOutput, snapshot.heatIndexTenthsC, snapshot.tempMode);
+  consoleOutput.print('\t');
+  consoleOutput.print(SettingsController::HeatModeString(snapshot.heatMode));
+  consoleOutput.print('\t');
+  printTemperature(consoleOutput, snapshot.setCoolTenthsC, snapshot.tempMode);
+  consoleOutput.print('\t');
+  printTemperature(consoleOutput, snapshot.setHeatTenthsC, snapshot.tempMode);
+  consoleOutput.print('\t');
+  consoleOutput.print(snapshot.hysteresisBandCentiC / 100.0, 2);
+  consoleOutput.println();
+}
+
+void helpCommand(const ConsoleArguments & args, Print & out) {
+  serialConsole.PrintCommands();
+}
+
+void getCommand(const ConsoleArguments & args, Print & out) {
+  ControlSnapshot snapshot;
+  controlSnapshot.Read(snapshot);
+
+  out.print(F("temp "));
+  printTemperature(out, snapshot.tempTenthsC, snapshot.tempMode);
+  out.print(F(" humidity "));
+  out.print(snapshot.humidityRel, 1);
+  out.print(F(" mode "));
+  out.print(SettingsController::HeatModeString(snapshot.heatMode));
+  out.print(F(" heat "));
+  printTemperature(out, snapshot.setHeatTenthsC, snapshot.tempMode);
+  out.print(F(" cool "));
+  printTemperature(out, snapshot.setCoolTenthsC, snapshot.tempMode);
+  out.print(F(" sensor "));
+  out.println(snapshot.isReadingValid ? F("ok") : F("stale"));
+}
+
+void setCommand(const ConsoleArguments & args, Print & out) {
+  int16_t tenths;
+  if(!args.ParseTenths(2, tenths)) {
+    out.println(F("usage: set heat|cool <temperature>"));
+    return;
+  }
+
+  ControlSnapshot snapshot;
+  controlSnapshot.Read(snapshot);
+
+  // entries are in the current unit, farenheit setpoints are whole degrees like the buttons
+  int16_t tenthsC = snapshot.tempMode == F
+      ? TemperatureConverter::WholeFToTenthsC((tenths + (tenths < 0 ? -5 : 5)) / 10)
+      : tenths;
+
+  if(args.Is(1, PSTR("heat")))
+    postSettingCommand(out, SettingHeatSetpoint, tenthsC, ReplySetpoints);
+  else if(args.Is(1, PSTR("cool")))
+    postSettingCommand(out, SettingCoolSetpoint, tenthsC, ReplySetpoints);
+  else
+    out.println(F("usage: set heat|cool <temperature>"));
+}
+
+void modeCommand(const ConsoleArguments & args, Print & out) {
+  if(args.Is(1, PSTR("off")))
+    postSettingCommand(out, SettingHeatMode, Off, ReplyHeatMode);
+  else if(args.Is(1, PSTR("heat")))
+    postSettingCommand(out, SettingHeatMode, Heat, ReplyHeatMode);
+  else if(args.Is(1, PSTR("cool")))
+    postSettingCommand(out, SettingHeatMode, Cool, ReplyHeatMode);
+  else if(args.Count() > 1)
+    out.println(F("usage: mode off|heat|cool"));
+  else {
+    ControlSnapshot snapshot;
+    controlSnapshot.Read(snapshot);
+    printReply(out, ReplyHeatMode, snapshot);
+  }
+}
+
+void unitCommand(const ConsoleArguments & args, Print & out) {
+  if(args.Is(1, PSTR("c")))
+    postSettingCommand(out, SettingTempMode, C, ReplyTempMode);
+  else if(args.Is(1, PSTR("f")))
+    postSettingCommand(out, SettingTempMode, F, ReplyTempMode);
+  else if(args.Count() > 1)
+    out.println(F("usage: unit c|f"));
+  else {
+    ControlSnapshot snapshot;
+    controlSnapshot.Read(snapshot);
+    printReply(out, ReplyTempMode, snapshot);
+  }
+}
+
+void postSettingCommand(Print & out, SettingCommandKind kind, int16_t value, ConsoleReply reply) {
+  SettingCommand command = { kind, value };
+  if(!settingCommands.Post(command)) {
+    out.println(F("busy, try again"));
+    return;
+  }
+
+  pendingReply = reply;
+}
+
+void printReply(Print & out, ConsoleReply reply, const ControlSnapshot & snapshot) {
+  switch(reply) {
+    case ReplySetpoints:
+      out.print(F("heat "));
+      printTemperature(out, snapshot.setHeatTenthsC, snapshot.tempMode);
+      out.print(F(" cool "));
+      printTemperature(out, snapshot.setCoolTenthsC, snapshot.tempMode);
+      out.println();
+      break;
+    case ReplyHeatMode:
+      out.println(SettingsController::HeatModeString(snapshot.heatMode));
+      break;
+    case ReplyTempMode:
+      out.println(TemperatureConverter::UnitSymbol(snapshot.tempMode));
+      break;
+    case ReplyNone:
+    default:
+      break;
+  }
+}
+
+
+void statsCommand(const ConsoleArguments & args, Print & out) {
+  // the control step copies and resets its counters in one piece, the UI step prints them once they are there
+  if(!statsReports.Request())
+    out.println(F("busy, try again"));
+}
+
+void printStats(Print & out, const StatsReport & report, const ControlSnapshot & snapshot) {
+  out.print(F("uptime_ms "));
+  out.print(report.nowMs);
+  out.print(F(" first_decision_us "));
+  out.print(report.firstDecisionMicros);
+  out.print(F(" loops "));
+  out.print(report.loopCount);
+  out.print(F(" max_loop_us "));
+  out.print(report.maxLoopMicros);
+#ifdef THERMOSTAT_RTOS_TASKS
+  out.print(F(" control_jitter_us "));
+  out.print(report.maxControlJitterMicros);
+#endif
+  out.print(F(" serial_dropped "));
+  out.print(serialOutput.DroppedBytes());
+  out.print(F(" serial_high_water "));
+  out.print(serialOutput.HighWaterMark());
+  out.print(F(" sensor_errors "));
+  out.print(report.sensorErrors);
+  out.print(F(" sensor_reinits "));
+  out.print(report.sensorReinits);
+  out.print(F(" sensor_fallbacks "));
+  out.print(report.sensorFallbacks);
+  out.print(F(" sensor_noise_c "));
+  out.print(snapshot.sensorNoiseCentiC / 100.0, 2);
+  out.print(F(" hvac_band_c "));
+  out.print(snapshot.hysteresisBandCentiC / 100.0, 2);
+  out.print(F(" i2c_recoveries "));
+  out.print(report.i2cRecoveries);
+  out.print(F(" i2c_sensor_permille "));
+  out.print(report.i2c[SensorClient].utilizationPerMille);
+  out.print(F(" i2c_sensor_transactions "));
+  out.print(report.i2c[SensorClient].transactions);
+  out.print(F(" i2c_display_permille "));
+  out.print(report.i2c[DisplayClient].utilizationPerMille);
+  out.print(F(" i2c_display_transactions "));
+  out.print(report.i2c[DisplayClient].transactions);
+#ifndef THERMOSTAT_MEMORY_LEAN
+  out.print(F(" history_blocks "));
+  out.print(historyStore.StoredBlocks());
+  out.print(F(" history_lost "));
+  out.print(historyStore.LostRecords());
+#endif
+  out.print(F(" trace_lost "));
+  out.println(InputTraceRecorder::LostRecords());
+
+  // the serial counters belong to the UI side
+  serialOutput.ResetCounters();
+}
+
+void runtimeCommand(const ConsoleArguments & args, Print & out) {
+  // the control step copies the counters in one piece, the UI step prints them once they are there
+  if(!runtimeReports.Request())
+    out.println(F("busy, try again"));
+}
+
+void printRecovery(Print & out, const __FlashStringHelper *name, const RecoveryModel & model,
+                   RecoveryDirection direction) {
+  out.print(name);
+  out.print(F(" cycles "));
+  out.print(model.LearnedCycles(direction));
+  out.print(F(" rate_c_per_h "));
+  out.print(model.RateCentiCPerHour(direction) / 100.0, 2);
+  out.print(F(" undershoot_c "));
+  out.print(model.UndershootCentiC(direction) / 100.0, 2);
+  out.print(F(" overshoot_c "));
+  out.println(model.OvershootCentiC(direction) / 100.0, 2);
+}
+
+void printRelayRuntime(Print & out, const __FlashStringHelper *name, const RelayRuntimeStats & stats,
+                       unsigned long nowMs) {
+  const RelayRuntimeTotals & totals = stats.Totals();
+
+  out.print(name);
+  out.print(F(" on_s "));
+  out.print(stats.OnSeconds(nowMs));
+  out.print(F(" cycles "));
+  out.print(totals.cycles);
+  out.print(F(" per_hour "));
+  out.print(stats.CyclesPerHour(nowMs));
+  out.print(F(" longest_s "));
+  out.print(totals.longestRunSeconds);
+  out.print(F(" shortest_s "));
+  out.println(totals.shortestRunSeconds);
+}
+
+void telemetryCommand(const ConsoleArguments & args, Print & out) {
+  if(args.Is(1, PSTR("on")))
+    isTelemetryOn = true;
+  else if(args.Is(1, PSTR("off")))
+    isTelemetryOn = false;
+  else if(args.Count() > 1) {
+    out.println(F("usage: telemetry on|off"));
+    return;
+  }
+
+  out.println(isTelemetryOn ? F("on") : F("off"));
+}
+
+#ifndef THERMOSTAT_MEMORY_LEAN
+void historyCommand(const ConsoleArguments & args, Print & out) {
+  // the lines follow over the next loop passes, telemetry in between is best turned off first
+  if(!historyStore.IsBegun())
+    out.println(F("history storage not mounted"));
+  else if(!historyStore.StartExport(out))
+    out.println(F("history export already running"));
+}
+#endif
+
+void printTemperature(Print & out, int16_t tenthsC, ThermostatTemperatureMode mode) {
+  TemperatureConverter::PrintTenths(out, TemperatureConverter::ToDisplayTenths(tenthsC, mode));
+  out.print(TemperatureConverter::UnitSymbol(mode));
+}
+
+void statusOverlay(Adafruit_SSD1306 & screen) {
+  screen.setTextSize(1);
+  screen.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+  screen.setCursor(0, 0);
+
+  ControlSnapshot snapshot;
+  controlSnapshot.Read(snapshot);
+
+  printTemperature(screen, snapshot.tempTenthsC, snapshot.tempMode);
+  screen.print(' ');
+  screen.print(snapshot.humidityRel, 0);
+  screen.print(F("% Td "));
+  printTemperature(screen, snapshot.dewPointTenthsC, snapshot.tempMode);
+
+  // how hard the equipment is being cycled
+  screen.setCursor(0, 8);
+  screen.print(F("C "));
+  screen.print(snapshot.coolCyclesPerHour);
+  screen.print(F("/h H "));
+  screen.print(snapshot.heatCyclesPerHour);
+  screen.print(F("/h"));
+}
@@ -0,0 +1,35 @@
+#include "HostThermostat.h"
+#include "BoardPins.h"
+
+HostThermostat::HostThermostat()
+  : settingsController(
+          StableDebouncer(buttonDebounceMs), StableDebouncer(buttonDebounceMs),
+          UpButtonPin(), DownButtonPin(), HeatModeButtonPin(), TempModeButtonPin()),
+    sensorController(sensorReadBounceMs),
+    hvacController(hvacChangeDebounceMs, hvacOnBufferC, CoolRelayPin(), HeatRelayPin(), FanRelayPin()) { }
+
+void HostThermostat::Setup(const HostFeatures & features) {
+  hvacController.Initialize();
+
+  sensorController.SetErrorHandling(nullptr, sensorStaleAfterMs, sensorRecoverAfterErrors);
+  if (sensorPeriodicMode)
+    sensorController.SetPeriodicMode(sensorPeriodicRepeatability, sensorPeriodicRate);
+  sensorController.Initialize();
+  settingsController.SetIncrementAcceleration(HoldAcceleration(buttonHoldCurve, sizeof(buttonHoldCurve) / sizeof(buttonHoldCurve[0])));
+  settingsController.SetDecrementAcceleration(HoldAcceleration(buttonHoldCurve, sizeof(buttonHoldCurve) / sizeof(buttonHoldCurve[0])));
+  settingsController.Initialize();
+
+  hvacController.SetCoolMinOffTime(coolMinOffMs);
+  if (features.isDehumidifyOnCool)
+    hvacController.EnableDehumidifyOnCool(dehumidifyMaxDewPointC, dehumidifyDewPointMarginC);
+  if (features.isPredictiveStartStop)
+    hvacController.EnablePredictiveStartStop();
+  if (features.isAdaptiveBand)
+    hvacController.EnableAdaptiveBand(hvacBandMinC, hvacBandMaxC, hvacTargetCyclesPerHour);
+}
+
+void HostThermostat::Step() {
+  settingsController.LoopHandler();
+  sensorController.LoopHandler();
+  hvacController.LoopHandler(sensorController, settingsController);
+}
@@ -0,0 +1,220 @@
+/*
+ * Deterministic host replay of an input trace recorded with THERMOSTAT_TRACE_RECORD (see InputTrace.h).
+ *
+ *   pio run -e replay
+ *   .pio/build/replay/program replay <trace.bin> <decisions.txt> [step ms]
+ *   .pio/build/replay/program diff <decisions-a.txt> <decisions-b.txt>
+ *
+ * Replay drives the real SettingsController, SensorController and HvacController, set up as main.cpp does (see
+ * HostThermostat.h), on a virtual clock, one loop pass every step (10ms by default), feeding them the traced button
+ * edges, sensor readings and console setting changes, and writes a line per relay change: "<ms> <cool> <heat> <fan>".
+ * Run it on the same trace with two builds and diff the outputs to check that a change to the control path is
+ * behaviour-identical.
+ *
+ * The build has the pin map of the recording board, env:replay defines ESP32_S2_DEV like env:featheresp32-s2-trace.
+ * A trace from another board, or with an edge on a pin no controller reads, is refused rather than replayed as if
+ * nobody pressed a button.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ReplayShim.h"
+#include "InputTrace.h"
+#include "HostThermostat.h"
+
+/// The default virtual time between loop passes
+static const unsigned long defaultStepMs = 10;
+
+/// Read a whole file, returns nullptr on failure
+static uint8_t *readFile(const char *path, size_t & size) {
+  FILE *file = fopen(path, "rb");
+  if (!file) return nullptr;
+
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  uint8_t *contents = (uint8_t *)malloc(length > 0 ? length : 1);
+  size = contents ? fread(contents, 1, length, file) : 0;
+  fclose(file);
+
+  return contents;
+}
+
+/// Check a traced pin is one of the buttons the settings controller reads
+static bool isButtonPin(uint8_t pin) {
+  return pin == Pins::ButtonUp || pin == Pins::ButtonDown || pin == Pins::TempModeToggle
+         || pin == Pins::HeatModeToggle;
+}
+
+/// Write a relay decision line if any relay changed since the last one
+static void writeDecision(FILE *out, unsigned long ms, uint8_t & lastRelays, bool force) {
+  uint8_t relays = (ReplayPinLevel(Pins::LedCool) ? 1 : 0) | (ReplayPinLevel(Pins::LedHeat) ? 2 : 0)
+                   | (ReplayPinLevel(Pins::LedFan) ? 4 : 0);
+  if (!force && relays == lastRelays) return;
+
+  fprintf(out, "%lu %d %d %d\n", ms, relays & 1, (relays >> 1) & 1, (relays >> 2) & 1);
+  lastRelays = relays;
+}
+
+static int replay(const char *tracePath, const char *decisionsPath, unsigned long stepMs) {
+  size_t size = 0;
+  uint8_t *trace = readFile(tracePath, size);
+  if (!trace) {
+    fprintf(stderr, "cannot read %s\n", tracePath);
+    return 2;
+  }
+
+  // anything written to the port before recording started (the boot banner) is skipped
+  size_t position = 0;
+  while (position + 5 <= size && !(trace[position] == 'T' && trace[position + 1] == 'I' && trace[position + 2] == 'O'))
+    position++;
+  if (position + 5 > size || trace[position + 3] != INPUT_TRACE_VERSION) {
+    fprintf(stderr, "%s is not a version %d input trace\n", tracePath, INPUT_TRACE_VERSION);
+    free(trace);
+    return 2;
+  }
+  if (trace[position + 4] != CurrentBoard) {
+    fprintf(stderr, "%s was recorded on board %d, this replay build has the pins of board %d\n", tracePath,
+            trace[position + 4], CurrentBoard);
+    free(trace);
+    return 2;
+  }
+  position += 5;
+
+  FILE *out = fopen(decisionsPath, "w");
+  if (!out) {
+    fprintf(stderr, "cannot write %s\n", decisionsPath);
+    free(trace);
+    return 2;
+  }
+
+  HostThermostat thermostat;
+  ReplaySetMillis(0);
+  thermostat.Setup();
+
+  unsigned long now = 0;
+  unsigned long recordMs = 0;
+  unsigned long records = 0;
+  uint8_t lastRelays = 0;
+  int result = 0;
+  writeDecision(out, now, lastRelays, true);
+
+  while (position < size) {
+    uint8_t tag = trace[position++];
+
+    unsigned long delta = 0;
+    uint8_t shift = 0;
+    while (position < size) {
+      uint8_t group = trace[position++];
+      delta |= (unsigned long)(group & 0x7f) << shift;
+      shift += 7;
+      if (!(group & 0x80)) break;
+    }
+    recordMs += delta;
+
+    // run the control loop up to the moment the input changed
+    while (now + stepMs <= recordMs) {
+      now += stepMs;
+      ReplaySetMillis(now);
+
+      thermostat.Step();
+
+      writeDecision(out, now, lastRelays, false);
+    }
+
+    if (tag == InputTraceSensor && position + 4 <= size) {
+      int16_t tempCentiC = (int16_t)(trace[position] | (trace[position + 1] << 8));
+      uint16_t humidityCentiRel = (uint16_t)(trace[position + 2] | (trace[position + 3] << 8));
+      ReplaySetSensorReading(tempCentiC / 100.0f, humidityCentiRel / 100.0f);
+      position += 4;
+    }
+    else if (tag == InputTraceSensorError) {
+      ReplaySetSensorFailing();
+    }
+    else if (tag == InputTracePin && position + 2 <= size) {
+      if (!isButtonPin(trace[position])) {
+        fprintf(stderr, "edge on pin %d at %lu ms, no controller reads it, stopping\n", trace[position], recordMs);
+        result = 1;
+        break;
+      }
+
+      ReplaySetPinLevel(trace[position], trace[position + 1]);
+      position += 2;
+    }
+    else if (tag == InputTraceSetting && position + 3 <= size) {
+      SettingCommand command;
+      command.kind = (SettingCommandKind)trace[position];
+      command.value = (int16_t)(trace[position + 1] | (trace[position + 2] << 8));
+      thermostat.settingsController.ApplyCommand(command);
+      position += 3;
+    }
+    else {
+      fprintf(stderr, "corrupt record at byte %lu, stopping\n", (unsigned long)position);
+      result = 1;
+      break;
+    }
+
+    records++;
+  }
+
+  fclose(out);
+  free(trace);
+
+  fprintf(stderr, "replayed %lu records over %lu ms\n", records, now);
+  return result;
+}
+
+static int diff(const char *pathA, const char *pathB) {
+  FILE *a = fopen(pathA, "r");
+  FILE *b = fopen(pathB, "r");
+  if (!a || !b) {
+    fprintf(stderr, "cannot read %s\n", !a ? pathA : pathB);
+    if (a) fclose(a);
+    if (b) fclose(b);
+    return 2;
+  }
+
+  char lineA[64];
+  char lineB[64];
+  unsigned long line = 0;
+  unsigned long mismatches = 0;
+
+  while (true) {
+    bool hasA = fgets(lineA, sizeof(lineA), a) != nullptr;
+    bool hasB = fgets(lineB, sizeof(lineB), b) != nullptr;
+    if (!hasA && !hasB) break;
+
+    line++;
+    if (hasA && hasB && strcmp(lineA, lineB) == 0) continue;
+
+    if (mismatches++ == 0) {
+      printf("first divergence at decision %lu\n", line);
+      printf("  a: %s", hasA ? lineA : "<end>\n");
+      printf("  b: %s", hasB ? lineB : "<end>\n");
+    }
+  }
+
+  fclose(a);
+  fclose(b);
+
+  if (mismatches == 0) printf("identical, %lu decisions\n", line);
+  else printf("%lu of %lu decisions differ\n", mismatches, line);
+
+  return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  if (argc >= 4 && strcmp(argv[1], "replay") == 0) {
+    unsigned long stepMs = argc >= 5 ? strtoul(argv[4], nullptr, 10) : defaultStepMs;
+    return replay(argv[2], argv[3], stepMs > 0 ? stepMs : defaultStepMs);
+  }
+
+  if (argc == 4 && strcmp(argv[1], "diff") == 0)
+    return diff(argv[2], argv[3]);
+
+  fprintf(stderr, "usage: %s replay <trace.bin> <decisions.txt> [step ms]\n", argv[0]);
+  fprintf(stderr, "       %s diff <decisions-a.txt> <decisions-b.txt>\n", argv[0]);
+  return 2;
+}
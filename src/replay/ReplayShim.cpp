@@ -0,0 +1,55 @@
+#include "ReplayShim.h"
+#include "Wire.h"
+#include "SHT31.h"
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static unsigned long replayMillis = 0;
+static uint8_t replayInputLevels[256] = {0};
+static uint8_t replayOutputLevels[256] = {0};
+static float replayTempC = 0;
+static float replayHumidityRel = 0;
+static bool isReplaySensorFailing = false;
+
+void ReplaySetMillis(unsigned long ms) { replayMillis = ms; }
+
+void ReplaySetPinLevel(uint8_t pin, uint8_t level) { replayInputLevels[pin] = level; }
+
+uint8_t ReplayPinLevel(uint8_t pin) { return replayOutputLevels[pin]; }
+
+void ReplaySetSensorReading(float tempC, float humidityRel) {
+  replayTempC = tempC;
+  replayHumidityRel = humidityRel;
+  isReplaySensorFailing = false;
+}
+
+void ReplaySetSensorFailing() { isReplaySensorFailing = true; }
+
+unsigned long millis() { return replayMillis; }
+
+unsigned long micros() { return replayMillis * 1000; }
+
+void delay(unsigned long ms) { replayMillis += ms; }
+
+void delayMicroseconds(unsigned int) { }
+
+void pinMode(uint8_t, uint8_t) { }
+
+int digitalRead(uint8_t pin) { return replayInputLevels[pin]; }
+
+void digitalWrite(uint8_t pin, uint8_t value) { replayOutputLevels[pin] = value; }
+
+long random(long max) { return max > 0 ? rand() % max : 0; }
+
+long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
+
+bool SHT31::read(bool) {
+  if (isReplaySensorFailing) return false;
+
+  _temperature = replayTempC;
+  _humidity = replayHumidityRel;
+  return true;
+}
+
+bool SHT31::readData(bool fast) { return read(fast); }
@@ -0,0 +1,179 @@
+/*
+ * AdaptiveBand on scripted cycle rates and readings, and the adaptive band through the real HvacController on rooms
+ * with an oversized and a weak heater.  Runs on the host with the replay stand-ins for the Arduino core:
+ *
+ *   pio test -e native -f test_adaptive_band
+ */
+#include <unity.h>
+
+#include "ReplayShim.h"
+#include "HostThermostat.h"
+#include "AdaptiveBand.h"
+
+/// A room with a heater that acts at once, losing heat to the outside
+struct Room {
+  /// @brief The temperature in celcius
+  double tempC = 20.0;
+
+  /// @brief The warming with the heater on, in celcius per hour
+  double heaterCPerHour;
+
+  /// @brief Advance the room
+  /// @param isHeatOn The heating relay state
+  /// @param stepMs The time to advance
+  void Step(bool isHeatOn, unsigned long stepMs) {
+    tempC += ((isHeatOn ? heaterCPerHour : 0.0) - (tempC - outsideC) * lossPerHour) * stepMs / 3600000.0;
+  }
+
+  /// @brief The outside temperature
+  static constexpr double outsideC = 10.0;
+
+  /// @brief The share of the difference to outside lost per hour
+  static constexpr double lossPerHour = 0.5;
+};
+
+/// The time between loop passes of the closed loop runs
+static const unsigned long loopStepMs = 100;
+
+/// What a closed loop run ended on
+struct BandRun {
+  int16_t bandCentiC;
+  int16_t noiseCentiC;
+  uint16_t cyclesPerHour;
+};
+
+/// Run a room for a day in heat mode with the shipped configuration, adaptive band and predictive start/stop both on.
+/// The reading carries up to 0.05 degrees of noise.
+static BandRun runHeat(double heaterCPerHour) {
+  ReplaySetMillis(0);
+  Room room;
+  room.heaterCPerHour = heaterCPerHour;
+  ReplaySetSensorReading(room.tempC, 40.0f);
+
+  HostThermostat thermostat;
+  thermostat.Setup();
+  thermostat.settingsController.ChangeHeatMode(Heat);
+  thermostat.settingsController.ChangeHeatTenthsC(210);
+  HvacController & hvacController = thermostat.hvacController;
+
+  uint32_t noiseState = 1;
+  unsigned long now;
+
+  for (now = loopStepMs; now < 24UL * 3600000UL; now += loopStepMs) {
+    ReplaySetMillis(now);
+    room.Step(hvacController.IsHeatOn(), loopStepMs);
+
+    noiseState = noiseState * 1103515245UL + 12345UL;
+    ReplaySetSensorReading(room.tempC + ((int)((noiseState >> 16) % 101) - 50) / 1000.0, 40.0f);
+
+    thermostat.Step();
+  }
+
+  BandRun run;
+  run.bandCentiC = (int16_t)(hvacController.HysteresisBandC() * 100.0f + 0.5f);
+  run.noiseCentiC = (int16_t)(hvacController.SensorNoiseC() * 100.0f + 0.5f);
+  run.cyclesPerHour = hvacController.HeatStats().CyclesPerHour(now);
+  return run;
+}
+
+/// Feed the band the same reading and cycle rate for a while, one decision every 5 seconds
+static void hold(AdaptiveBand & band, int16_t tempCentiC, uint16_t cyclesPerHour, unsigned long & nowMs,
+                 unsigned long forMs) {
+  unsigned long endMs = nowMs + forMs;
+  for (; nowMs < endMs; nowMs += 5000)
+    band.Update(tempCentiC, cyclesPerHour, nowMs);
+}
+
+void setUp() {
+  ReplaySetMillis(0);
+}
+
+void tearDown() { }
+
+void test_fixed_band_keeps_the_configured_buffer() {
+  AdaptiveBand band(35);
+  unsigned long nowMs = 0;
+
+  hold(band, 2100, 12, nowMs, 3 * AdaptiveBand::AdjustPeriodMs);
+
+  TEST_ASSERT_EQUAL_INT16(35, band.BandCentiC());
+}
+
+void test_controller_switches_at_the_buffer_it_is_given() {
+  HvacController hvacController = HvacController(
+          hvacChangeDebounceMs, 0.3f, CoolRelayPin(), HeatRelayPin(), FanRelayPin());
+
+  TEST_ASSERT_EQUAL_INT16(30, (int16_t)(hvacController.HysteresisBandC() * 100.0f + 0.5f));
+}
+
+void test_widens_a_step_per_period_while_cycling_fast() {
+  AdaptiveBand band(50);
+  band.Enable(20, 150, 3);
+  unsigned long nowMs = 0;
+
+  hold(band, 2100, 6, nowMs, AdaptiveBand::AdjustPeriodMs - 5000);
+  TEST_ASSERT_EQUAL_INT16(50, band.BandCentiC());
+
+  hold(band, 2100, 6, nowMs, 10000);
+  TEST_ASSERT_EQUAL_INT16(50 + AdaptiveBand::StepCentiC, band.BandCentiC());
+
+  hold(band, 2100, 6, nowMs, 100 * AdaptiveBand::AdjustPeriodMs);
+  TEST_ASSERT_EQUAL_INT16(150, band.BandCentiC());
+}
+
+void test_idle_system_leaves_the_band_alone() {
+  AdaptiveBand band(50);
+  band.Enable(20, 150, 3);
+  unsigned long nowMs = 0;
+
+  hold(band, 2100, 0, nowMs, 5 * AdaptiveBand::AdjustPeriodMs);
+
+  TEST_ASSERT_EQUAL_INT16(50, band.BandCentiC());
+}
+
+void test_never_narrows_below_the_noise_floor() {
+  AdaptiveBand band(50);
+  band.Enable(5, 150, 3);
+  unsigned long nowMs = 0;
+  unsigned long endMs = 20 * AdaptiveBand::AdjustPeriodMs;
+
+  // readings 0.2 apart on every decision
+  int16_t tempCentiC = 2090;
+  for (; nowMs < endMs; nowMs += 5000) {
+    tempCentiC = tempCentiC == 2090 ? 2110 : 2090;
+    band.Update(tempCentiC, 1, nowMs);
+  }
+
+  TEST_ASSERT_INT_WITHIN(1, 20, band.NoiseCentiC());
+  TEST_ASSERT_EQUAL_INT16(band.NoiseCentiC() * AdaptiveBand::NoiseMultiple, band.BandCentiC());
+}
+
+void test_oversized_heater_settles_at_the_target_rate() {
+  BandRun run = runHeat(80.0);
+
+  // short cycles at the starting band, widened until the rate is down to the target
+  TEST_ASSERT_GREATER_THAN((int16_t)(hvacOnBufferC * 100.0f + 0.5f), run.bandCentiC);
+  TEST_ASSERT_INT_WITHIN(1, hvacTargetCyclesPerHour, run.cyclesPerHour);
+}
+
+void test_weak_heater_narrows_toward_the_noise_floor() {
+  BandRun run = runHeat(8.0);
+
+  // long cycles at the starting band, narrowed until the minimum or the noise floor holds it
+  TEST_ASSERT_LESS_THAN((int16_t)(hvacOnBufferC * 100.0f + 0.5f), run.bandCentiC);
+  TEST_ASSERT_GREATER_OR_EQUAL((int16_t)(hvacBandMinC * 100.0f + 0.5f), run.bandCentiC);
+  TEST_ASSERT_GREATER_OR_EQUAL(run.noiseCentiC * AdaptiveBand::NoiseMultiple, run.bandCentiC);
+  TEST_ASSERT_INT_WITHIN(2, hvacTargetCyclesPerHour, run.cyclesPerHour);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_band_keeps_the_configured_buffer);
+  RUN_TEST(test_controller_switches_at_the_buffer_it_is_given);
+  RUN_TEST(test_widens_a_step_per_period_while_cycling_fast);
+  RUN_TEST(test_idle_system_leaves_the_band_alone);
+  RUN_TEST(test_never_narrows_below_the_noise_floor);
+  RUN_TEST(test_oversized_heater_settles_at_the_target_rate);
+  RUN_TEST(test_weak_heater_narrows_toward_the_noise_floor);
+  return UNITY_END();
+}
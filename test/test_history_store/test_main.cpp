@@ -0,0 +1,221 @@
+/*
+ * HistoryStore recording and export round trip, on the RAM block ring the host build keeps.  Runs on the host with
+ * the replay stand-ins for the Arduino core:
+ *
+ *   pio test -e native -f test_history_store
+ */
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ReplayShim.h"
+#include "HistoryStore.h"
+
+/// Collects export lines
+class LineCapture : public Print {
+  public:
+    /// @brief The longest line kept
+    static constexpr size_t LineBytes = 80;
+
+    /// @brief The most lines kept
+    static constexpr size_t MaxLines = 4000;
+
+    size_t write(uint8_t value) override {
+      if (value == '\r') return 1;
+      if (value == '\n') {
+        if (count < MaxLines) count++;
+        length = 0;
+        return 1;
+      }
+
+      if (count < MaxLines && length < LineBytes - 1) {
+        lines[count][length++] = value;
+        lines[count][length] = '\0';
+      }
+      return 1;
+    }
+
+    int availableForWrite() override { return 256; }
+
+    /// @brief The completed lines
+    char lines[MaxLines][LineBytes];
+
+    /// @brief The number of completed lines
+    size_t count = 0;
+
+  private:
+    /// @brief The length of the line being written
+    size_t length = 0;
+};
+
+/// The time between history samples
+static const unsigned long intervalMs = 60000;
+
+/// What was recorded, to compare the export against
+struct Expected {
+  static constexpr size_t MaxEntries = 1000;
+
+  long sampleSeconds[MaxEntries];
+  int sampleTemp[MaxEntries];
+  int sampleHumidity[MaxEntries];
+  size_t samples = 0;
+
+  long relaySeconds[MaxEntries];
+  int relays[MaxEntries];
+  size_t relayChanges = 0;
+};
+
+static HistoryStore *store;
+static LineCapture *capture;
+static Expected *expected;
+static unsigned long nowMs;
+
+/// Run the export to the end, the control side keeps recording the same reading meanwhile
+static void exportAll(int16_t tempTenthsC, uint16_t humidityTenthsRel, uint8_t relays) {
+  TEST_ASSERT_TRUE(store->StartExport(*capture));
+
+  int passes;
+  for (passes = 0; passes < 20000 && store->IsExporting(); passes++) {
+    ReplaySetMillis(nowMs += 10);
+    store->Record(tempTenthsC, humidityTenthsRel, true, relays);
+    store->LoopHandler();
+  }
+
+  TEST_ASSERT_FALSE(store->IsExporting());
+}
+
+void setUp() {
+  nowMs = 0;
+  ReplaySetMillis(0);
+  store = new HistoryStore(intervalMs);
+  capture = new LineCapture();
+  expected = new Expected();
+}
+
+void tearDown() {
+  delete store;
+  delete capture;
+  delete expected;
+}
+
+void test_export_refused_before_begin() {
+  TEST_ASSERT_FALSE(store->IsBegun());
+  TEST_ASSERT_FALSE(store->StartExport(*capture));
+  TEST_ASSERT_FALSE(store->IsExporting());
+}
+
+void test_empty_store_exports_only_the_frame() {
+  TEST_ASSERT_TRUE(store->Begin());
+
+  exportAll(215, 450, 0);
+
+  TEST_ASSERT_EQUAL(2, capture->count);
+  TEST_ASSERT_EQUAL_STRING("hist begin", capture->lines[0]);
+  TEST_ASSERT_EQUAL_STRING("hist end", capture->lines[1]);
+}
+
+void test_round_trip_across_blocks() {
+  TEST_ASSERT_TRUE(store->Begin());
+
+  // deltas from a tenth to a few hundred degrees, so varints of one, two and three bytes, and a relay change every
+  // 37 seconds, some of them landing in the last bytes of a block
+  int16_t tempTenthsC = 215;
+  uint16_t humidityTenthsRel = 450;
+  uint8_t relays = 0;
+  long nextSampleSeconds = 1;
+  long second;
+
+  for (second = 1; second <= 5 * 3600L; second++) {
+    nowMs = second * 1000UL;
+    ReplaySetMillis(nowMs);
+
+    if (second == nextSampleSeconds) {
+      long n = expected->samples;
+      if (n % 50 == 25) tempTenthsC += 4500;
+      else if (n % 50 == 26) tempTenthsC -= 4500;
+      else tempTenthsC += (int16_t)((n % 7 == 0) ? ((n % 2) ? 300 : -300) : ((n % 3) - 1) * (1 + n % 40));
+      humidityTenthsRel = (uint16_t)((n % 50 == 25) ? 9000 : 450 + (n % 11) * ((n % 5 == 0) ? 90 : 3));
+
+      expected->sampleSeconds[n] = second;
+      expected->sampleTemp[n] = tempTenthsC;
+      expected->sampleHumidity[n] = humidityTenthsRel;
+      expected->samples++;
+      nextSampleSeconds += intervalMs / 1000;
+    }
+    else if (second % 37 == 0) {
+      relays = (relays + 3) & 0x07;
+      expected->relaySeconds[expected->relayChanges] = second;
+      expected->relays[expected->relayChanges] = relays;
+      expected->relayChanges++;
+    }
+
+    store->Record(tempTenthsC, humidityTenthsRel, true, relays);
+    store->LoopHandler();
+  }
+
+  exportAll(tempTenthsC, humidityTenthsRel, relays);
+
+  // the whole run fits in the ring, so every block is still there
+  TEST_ASSERT_GREATER_THAN(3, store->StoredBlocks());
+  TEST_ASSERT_LESS_THAN(HistoryStore::MaxBlocks, store->StoredBlocks());
+
+  TEST_ASSERT_EQUAL_STRING("hist begin", capture->lines[0]);
+  TEST_ASSERT_EQUAL_STRING("hist end", capture->lines[capture->count - 1]);
+
+  size_t samples = 0;
+  size_t relayChanges = 0;
+  size_t lostRelayChanges = 0;
+  size_t blocks = 0;
+  long lastBlockSeq = -1;
+  size_t i;
+
+  for (i = 1; i + 1 < capture->count; i++) {
+    const char *line = capture->lines[i];
+    long seq, boot, interval, seconds, temp, humidity, relayBits;
+
+    if (sscanf(line, "b %ld %ld %ld %ld %ld %ld %ld", &seq, &boot, &interval, &seconds, &temp, &humidity,
+               &relayBits) == 7) {
+      TEST_ASSERT_EQUAL(lastBlockSeq + 1, seq);
+      TEST_ASSERT_EQUAL(intervalMs / 1000, interval);
+      lastBlockSeq = seq;
+      blocks++;
+    }
+    else if (sscanf(line, "s %ld %ld %ld", &seconds, &temp, &humidity) == 3) { }
+    else if (sscanf(line, "r %ld %ld", &seconds, &relayBits) == 2) {
+      // a change that finds its block full is counted lost and only shows in the next header
+      while (relayChanges < expected->relayChanges && expected->relaySeconds[relayChanges] < seconds) {
+        relayChanges++;
+        lostRelayChanges++;
+      }
+
+      TEST_ASSERT_TRUE(relayChanges < expected->relayChanges);
+      TEST_ASSERT_EQUAL(expected->relaySeconds[relayChanges], seconds);
+      TEST_ASSERT_EQUAL(expected->relays[relayChanges], relayBits);
+      relayChanges++;
+      continue;
+    }
+    else {
+      TEST_ASSERT_EQUAL_STRING("a b, s or r line", line);
+      return;
+    }
+
+    TEST_ASSERT_TRUE(samples < expected->samples);
+    TEST_ASSERT_EQUAL(expected->sampleSeconds[samples], seconds);
+    TEST_ASSERT_EQUAL(expected->sampleTemp[samples], temp);
+    TEST_ASSERT_EQUAL(expected->sampleHumidity[samples], humidity);
+    samples++;
+  }
+
+  TEST_ASSERT_EQUAL(store->StoredBlocks(), blocks);
+  TEST_ASSERT_EQUAL(expected->samples, samples);
+  TEST_ASSERT_EQUAL(store->LostRecords(), lostRelayChanges + (expected->relayChanges - relayChanges));
+  TEST_ASSERT_LESS_THAN(expected->relayChanges / 20, store->LostRecords());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_export_refused_before_begin);
+  RUN_TEST(test_empty_store_exports_only_the_frame);
+  RUN_TEST(test_round_trip_across_blocks);
+  return UNITY_END();
+}
@@ -0,0 +1,207 @@
+/*
+ * RecoveryModel on scripted temperatures, and predictive start/stop through the real HvacController on a room with
+ * a lagging heater.  Runs on the host with the replay stand-ins for the Arduino core:
+ *
+ *   pio test -e native -f test_recovery_model
+ */
+#include <unity.h>
+
+#include "ReplayShim.h"
+#include "HostThermostat.h"
+#include "RecoveryModel.h"
+
+/// A room heated by a heater whose output lags the relay, so the temperature keeps rising after a stop
+struct LaggingRoom {
+  /// @brief The temperature in celcius
+  double tempC = 20.0;
+
+  /// @brief The share of the heater output reaching the room, follows the relay with a lag
+  double heatShare = 0.0;
+
+  /// @brief Advance the room
+  /// @param isHeatOn The heating relay state
+  /// @param stepMs The time to advance
+  void Step(bool isHeatOn, unsigned long stepMs) {
+    double hours = stepMs / 3600000.0;
+
+    heatShare += ((isHeatOn ? 1.0 : 0.0) - heatShare) * hours / heatLagHours;
+    tempC += (heatShare * heaterCPerHour - (tempC - outsideC) * lossPerHour) * hours;
+  }
+
+  /// @brief The warming of the room with the heater fully on, in celcius per hour
+  static constexpr double heaterCPerHour = 6.0;
+
+  /// @brief The time constant of the heater output
+  static constexpr double heatLagHours = 15.0 / 60.0;
+
+  /// @brief The outside temperature
+  static constexpr double outsideC = 10.0;
+
+  /// @brief The share of the difference to outside lost per hour
+  static constexpr double lossPerHour = 0.1;
+};
+
+/// The time between loop passes of the closed loop runs
+static const unsigned long loopStepMs = 100;
+
+/// The heating setpoint and band of the closed loop runs in hundredths of a degree celcius
+static const int16_t heatSetCentiC = 2100;
+static const int16_t bandCentiC = (int16_t)(hvacOnBufferC * 100.0f + 0.5f);
+
+/// What a closed loop run saw on its second day once the model has learned, in hundredths of a degree celcius
+struct HeatRun {
+  int16_t maxStartCentiC = -9999;
+  int16_t minStopCentiC = 9999;
+  int16_t minTempCentiC = 9999;
+  int16_t maxTempCentiC = -9999;
+  int16_t overshootCentiC = 0;
+  uint8_t learnedCycles = 0;
+};
+
+/// Round celcius to hundredths
+static int16_t toCentiC(double tempC) { return (int16_t)(tempC * 100.0 + (tempC < 0 ? -0.5 : 0.5)); }
+
+/// Run the room for two days in heat mode, with the shipped configuration less the adaptive band so the band the leads
+/// are capped against stays at hvacOnBufferC, and with predictive start/stop as asked
+static HeatRun runHeat(bool isPredictive) {
+  HostFeatures features;
+  features.isAdaptiveBand = false;
+  features.isPredictiveStartStop = isPredictive;
+
+  ReplaySetMillis(0);
+  LaggingRoom room;
+  ReplaySetSensorReading(room.tempC, 40.0f);
+
+  HostThermostat thermostat;
+  thermostat.Setup(features);
+  thermostat.settingsController.ChangeHeatMode(Heat);
+  thermostat.settingsController.ChangeHeatTenthsC(heatSetCentiC / 10);
+  HvacController & hvacController = thermostat.hvacController;
+  SensorController & sensorController = thermostat.sensorController;
+
+  HeatRun run;
+  bool wasHeatOn = false;
+  unsigned long now;
+
+  for (now = loopStepMs; now < 48UL * 3600000UL; now += loopStepMs) {
+    ReplaySetMillis(now);
+    room.Step(hvacController.IsHeatOn(), loopStepMs);
+    ReplaySetSensorReading(room.tempC, 40.0f);
+
+    thermostat.Step();
+
+    if (now < 24UL * 3600000UL) {
+      wasHeatOn = hvacController.IsHeatOn();
+      continue;
+    }
+
+    int16_t readingCentiC = toCentiC(sensorController.CurrentTempC());
+    if (hvacController.IsHeatOn() && !wasHeatOn && readingCentiC > run.maxStartCentiC)
+      run.maxStartCentiC = readingCentiC;
+    else if (!hvacController.IsHeatOn() && wasHeatOn && readingCentiC < run.minStopCentiC)
+      run.minStopCentiC = readingCentiC;
+    wasHeatOn = hvacController.IsHeatOn();
+
+    int16_t tempCentiC = toCentiC(room.tempC);
+    if (tempCentiC < run.minTempCentiC) run.minTempCentiC = tempCentiC;
+    if (tempCentiC > run.maxTempCentiC) run.maxTempCentiC = tempCentiC;
+  }
+
+  run.overshootCentiC = hvacController.Recovery().OvershootCentiC(RecoveryHeat);
+  run.learnedCycles = hvacController.Recovery().LearnedCycles(RecoveryHeat);
+  return run;
+}
+
+/// Feed the model one decision
+static void update(RecoveryModel & model, bool isHeatOn, float tempC, unsigned long nowMs) {
+  model.Update(isHeatOn, false, toCentiC(tempC), nowMs);
+}
+
+void setUp() { }
+
+void tearDown() { }
+
+void test_nothing_learned_before_a_cycle() {
+  RecoveryModel model;
+
+  TEST_ASSERT_EQUAL_UINT8(0, model.LearnedCycles(RecoveryHeat));
+  TEST_ASSERT_EQUAL_INT16(0, model.RateCentiCPerHour(RecoveryHeat));
+  TEST_ASSERT_EQUAL_INT16(0, model.UndershootCentiC(RecoveryHeat));
+  TEST_ASSERT_EQUAL_INT16(0, model.OvershootCentiC(RecoveryHeat));
+}
+
+void test_learns_one_heating_cycle() {
+  RecoveryModel model;
+  unsigned long nowMs = 0;
+
+  // starts at 20.5, drifts down to 20.3 over two minutes, then rises 2 degrees an hour for half an hour
+  update(model, true, 20.5f, nowMs);
+  for (nowMs = 5000; nowMs <= 120000; nowMs += 5000)
+    update(model, true, 20.5f - 0.2f * nowMs / 120000, nowMs);
+  for (; nowMs <= 1920000; nowMs += 5000)
+    update(model, true, 20.3f + 2.0f * (nowMs - 120000) / 3600000, nowMs);
+
+  // stops at 21.3, coasts up to 21.6 and falls back
+  update(model, false, 21.3f, nowMs);
+  float tempC;
+  for (tempC = 21.3f; tempC < 21.6f; tempC += 0.05f)
+    update(model, false, tempC, nowMs += 5000);
+  for (; tempC > 21.2f; tempC -= 0.05f)
+    update(model, false, tempC, nowMs += 5000);
+
+  TEST_ASSERT_EQUAL_UINT8(1, model.LearnedCycles(RecoveryHeat));
+  TEST_ASSERT_INT_WITHIN(1, 20, model.UndershootCentiC(RecoveryHeat));
+  TEST_ASSERT_INT_WITHIN(5, 200, model.RateCentiCPerHour(RecoveryHeat));
+  TEST_ASSERT_INT_WITHIN(5, 30, model.OvershootCentiC(RecoveryHeat));
+  TEST_ASSERT_EQUAL_UINT8(0, model.LearnedCycles(RecoveryCool));
+}
+
+void test_cooling_is_learned_on_the_negated_temperature() {
+  RecoveryModel model;
+  unsigned long nowMs = 0;
+
+  // starts at 24.0 and falls a degree an hour, stops at 23.5 and coasts down to 23.3
+  for (nowMs = 0; nowMs <= 1800000; nowMs += 5000)
+    model.Update(false, true, (int16_t)(2400 - 100 * nowMs / 3600000), nowMs);
+  int16_t tempCentiC;
+  for (tempCentiC = 2350; tempCentiC >= 2330; tempCentiC -= 5)
+    model.Update(false, false, tempCentiC, nowMs += 5000);
+  for (; tempCentiC <= 2360; tempCentiC += 5)
+    model.Update(false, false, tempCentiC, nowMs += 5000);
+
+  TEST_ASSERT_EQUAL_UINT8(1, model.LearnedCycles(RecoveryCool));
+  TEST_ASSERT_INT_WITHIN(5, 100, model.RateCentiCPerHour(RecoveryCool));
+  TEST_ASSERT_INT_WITHIN(5, 20, model.OvershootCentiC(RecoveryCool));
+  TEST_ASSERT_EQUAL_UINT8(0, model.LearnedCycles(RecoveryHeat));
+}
+
+void test_leads_are_capped_at_half_the_band() {
+  HeatRun run = runHeat(true);
+
+  // the heater coasts further than half the band, so the cap is what holds the switch points apart
+  TEST_ASSERT_GREATER_THAN(5, run.learnedCycles);
+  TEST_ASSERT_GREATER_THAN(bandCentiC / 2, run.overshootCentiC);
+
+  TEST_ASSERT_GREATER_OR_EQUAL(heatSetCentiC + bandCentiC / 2 - 1, run.minStopCentiC);
+  TEST_ASSERT_LESS_OR_EQUAL(heatSetCentiC - bandCentiC / 2 + 1, run.maxStartCentiC);
+}
+
+void test_predictive_stop_trims_the_overshoot() {
+  HeatRun fixed = runHeat(false);
+  HeatRun predictive = runHeat(true);
+
+  // a fixed band stops at the top of the band and coasts past it, the predictive stop comes half a band early
+  TEST_ASSERT_GREATER_OR_EQUAL(heatSetCentiC + bandCentiC - 1, fixed.minStopCentiC);
+  TEST_ASSERT_LESS_THAN(fixed.maxTempCentiC - 20, predictive.maxTempCentiC);
+  TEST_ASSERT_GREATER_THAN(heatSetCentiC - bandCentiC - 10, predictive.minTempCentiC);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_nothing_learned_before_a_cycle);
+  RUN_TEST(test_learns_one_heating_cycle);
+  RUN_TEST(test_cooling_is_learned_on_the_negated_temperature);
+  RUN_TEST(test_leads_are_capped_at_half_the_band);
+  RUN_TEST(test_predictive_stop_trims_the_overshoot);
+  return UNITY_END();
+}